@@ -0,0 +1,220 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include "../cos/cos.hpp"
+#include "../exp/exp.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Benchmarks of the variants that take a runtime input, on inputs drawn from
+// a distribution instead of one constant (which lets the compiler fold or
+// hoist the computation out of the loop).
+//
+// Each variant is timed in two modes:
+//
+//     latency    : dependent chain, the next input waits for the result
+//     throughput : independent inputs, the results are stored
+//
+// The template struct variants only take compile-time inputs and are left
+// out; the compile-time arrays are looked up at the nearest integer input
+// (degree for cos).
+
+namespace Bench {
+
+//==============================================================================
+// Inputs
+//==============================================================================
+
+    struct Distribution
+    {
+        enum Kind { UNIFORM, NORMAL, FILE };
+
+        Kind kind;
+        double a, b;      // [lo, hi] or (mean, stddev)
+        std::string path; // Raw doubles, replayed in order
+    };
+
+    // Returns false if the file can not be read, or for no inputs
+    inline bool inputs(Distribution const & d, std::size_t samples, std::vector<double> & xs)
+    {
+        if(d.kind == Distribution::FILE)
+        {
+            std::ifstream in(d.path, std::ios::binary);
+            std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            xs.resize(bytes.size() / sizeof(double));
+            if(xs.empty()) return false;
+            std::memcpy(xs.data(), bytes.data(), xs.size() * sizeof(double));
+            return true;
+        }
+
+        if(samples == 0) return false;
+
+        std::mt19937_64 rng(42);
+        std::uniform_real_distribution<double> uniform(d.a, d.b);
+        std::normal_distribution<double> normal(d.a, d.b);
+        xs.resize(samples);
+        for(double & x : xs)
+            x = d.kind == Distribution::UNIFORM ? uniform(rng) : normal(rng);
+        return true;
+    }
+
+//==============================================================================
+// Timings
+//==============================================================================
+
+    // ns per call, the input of each call depending on the previous result.
+    // The dependency (an and, a min, a mul and an add) is timed alone by the
+    // "chain" row.
+    template <typename F>
+    double latency(F f, std::vector<double> const & xs, long n, double & sink)
+    {
+        if(xs.empty() || n <= 0) return 0.0;
+
+        double r = 0.0;
+        std::size_t const size = xs.size();
+        auto start = std::chrono::high_resolution_clock::now();
+        for(long i = 0, j = 0; i < n; ++i)
+        {
+            // 0 * min(|r|, 1) is 0 even for r infinite or NaN
+            r = f(xs[j] + 0.0 * std::fmin(std::fabs(r), 1.0));
+            if(++j == static_cast<long>(size)) j = 0;
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        sink += r;
+        return std::chrono::duration<double, std::nano>(end - start).count() / n;
+    }
+
+    // ns per call, over independent inputs
+    template <typename F>
+    double throughput(F f, std::vector<double> const & xs, long n, double & sink)
+    {
+        if(xs.empty()) return 0.0;
+
+        std::vector<double> out(xs.size());
+        long const passes = std::max(1L, n / static_cast<long>(xs.size()));
+        auto start = std::chrono::high_resolution_clock::now();
+        for(long p = 0; p < passes; ++p)
+        {
+            for(std::size_t i = 0; i < xs.size(); ++i)
+                out[i] = f(xs[i]);
+            sink += out[p % out.size()];
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / (passes * xs.size());
+    }
+
+    template <typename F>
+    void row(char const * name, F f, std::vector<double> const & xs, long n, double & sink)
+    {
+        double l = latency(f, xs, n, sink);
+        double t = throughput(f, xs, n, sink);
+        std::cout << std::setw(38) << std::left << name << std::right
+                  << std::setw(12) << l << std::setw(12) << t << std::endl;
+    }
+
+    inline void header()
+    {
+        std::cout << std::setw(38) << std::left << "ns per call" << std::right
+                  << std::setw(12) << "latency" << std::setw(12) << "throughput" << std::endl;
+    }
+
+//==============================================================================
+// Variants
+//==============================================================================
+
+    inline int index(double x, int size)
+    {
+        int i = static_cast<int>(std::lround(x));
+        return i < 0 ? 0 : (i >= size ? size - 1 : i);
+    }
+
+    inline void cos(std::vector<double> const & xs, long n, double & sink)
+    {
+        row("chain", [](double x) { return x; }, xs, n, sink);
+        row("std::cos", [](double x) { return std::cos(x); }, xs, n, sink);
+        row("Normal::Cos(x, 10)", [](double x) { return Normal::Cos(x, 10); }, xs, n, sink);
+        row("Inline::Cos(x, 10)", [](double x) { return Inline::Cos(x, 10); }, xs, n, sink);
+        row("RecursiveTemplateFunc::Cos<10>", [](double x) { return RecursiveTemplateFunc::Cos<10>(x); }, xs, n, sink);
+        row("Constexpr::Cos(x, 10)", [](double x) { return Constexpr::Cos(x, 10); }, xs, n, sink);
+        row("CompileTimeArray::cosinus", [](double x) {
+            return CompileTimeArray::cosinus[index(std::fabs(x) / TO_RAD, COS_ARRAY_SIZE)]; }, xs, n, sink);
+        row("ShallowCompileTimeArray::cosinus", [](double x) {
+            return ShallowCompileTimeArray::cosinus[index(std::fabs(x) / TO_RAD, COS_ARRAY_SIZE)]; }, xs, n, sink);
+    }
+
+    inline void exp(std::vector<double> const & xs, long n, double & sink)
+    {
+        row("chain", [](double x) { return x; }, xs, n, sink);
+        row("std::exp", [](double x) { return std::exp(x); }, xs, n, sink);
+        row("Normal::Exp(x, 20)", [](double x) { return Normal::Exp(x, 20); }, xs, n, sink);
+        row("Inline::Exp(x, 20)", [](double x) { return Inline::Exp(x, 20); }, xs, n, sink);
+        row("RecursiveTemplateFunc::Exp<20>", [](double x) { return RecursiveTemplateFunc::Exp<20>(x); }, xs, n, sink);
+        row("Constexpr::Exp(x, 20)", [](double x) { return Constexpr::Exp(x, 20); }, xs, n, sink);
+        row("CompileTimeArray::exponentials", [](double x) {
+            double e = CompileTimeArray::exponentials[index(std::fabs(x), EXP_ARRAY_SIZE)];
+            return x < 0.0 ? 1.0 / e : e; }, xs, n, sink);
+        row("ShallowCompileTimeArray::exponentials", [](double x) {
+            double e = ShallowCompileTimeArray::exponentials[index(std::fabs(x), EXP_ARRAY_SIZE)];
+            return x < 0.0 ? 1.0 / e : e; }, xs, n, sink);
+    }
+
+    // x^10 (the powers arrays hold 2^n, a function of the exponent only)
+    inline void pow(std::vector<double> const & xs, long n, double & sink)
+    {
+        row("chain", [](double x) { return x; }, xs, n, sink);
+        row("std::pow", [](double x) { return std::pow(x, 10); }, xs, n, sink);
+        row("Normal::Pow(x, 10)", [](double x) { return Normal::Pow(x, 10); }, xs, n, sink);
+        row("Inline::Pow(x, 10)", [](double x) { return Inline::Pow(x, 10); }, xs, n, sink);
+        row("RecursiveTemplateFunc::Pow<10>", [](double x) { return RecursiveTemplateFunc::Pow<10>(x); }, xs, n, sink);
+        row("Constexpr::Pow(x, 10)", [](double x) { return Constexpr::Pow(x, 10); }, xs, n, sink);
+    }
+
+    // Factorial of the nearest integer in [0, 170]
+    inline void factorial(std::vector<double> const & xs, long n, double & sink)
+    {
+        row("chain", [](double x) { return x; }, xs, n, sink);
+        row("std::tgamma", [](double x) { return std::tgamma(index(x, 171) + 1.0); }, xs, n, sink);
+        row("Normal::Factorial", [](double x) { return Normal::Factorial(index(x, 171)); }, xs, n, sink);
+        row("Inline::Factorial", [](double x) { return Inline::Factorial(index(x, 171)); }, xs, n, sink);
+        row("Constexpr::Factorial", [](double x) { return Constexpr::Factorial(index(x, 171)); }, xs, n, sink);
+        row("CompileTimeArray::factorials", [](double x) {
+            return CompileTimeArray::factorials[index(x, 171)]; }, xs, n, sink);
+        row("ShallowCompileTimeArray::factorials", [](double x) {
+            return ShallowCompileTimeArray::factorials[index(x, 171)]; }, xs, n, sink);
+    }
+
+//==============================================================================
+// Minimalist benchmark
+//==============================================================================
+
+    // Returns false for an unknown function or an unreadable file
+    inline bool benchmark(std::string const & function, long n, Distribution const & d,
+                          std::size_t samples)
+    {
+        std::vector<double> xs;
+        if(!inputs(d, samples, xs)) return false;
+
+        double sink = 0.0;
+        std::cout << std::fixed << std::setprecision(2);
+        header();
+        if(function == "cos") cos(xs, n, sink);
+        else if(function == "exp") exp(xs, n, sink);
+        else if(function == "pow") pow(xs, n, sink);
+        else if(function == "factorial") factorial(xs, n, sink);
+        else return false;
+        std::cout << std::endl << "(" << sink << ")" << std::endl;
+        return true;
+    }
+
+}
+
+#endif //BENCH_HPP
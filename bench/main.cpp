@@ -0,0 +1,98 @@
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "bench.hpp"
+#include "sweep.hpp"
+
+// Default inputs: where the series of order 10/20 are accurate
+static Bench::Distribution default_distribution(std::string const & function)
+{
+    if(function == "cos") return { Bench::Distribution::UNIFORM, -M_PI, M_PI, "" };
+    if(function == "exp") return { Bench::Distribution::UNIFORM, -5.0, 5.0, "" };
+    if(function == "pow") return { Bench::Distribution::UNIFORM, 0.5, 1.5, "" };
+    return { Bench::Distribution::UNIFORM, 0.0, 170.0, "" };
+}
+
+// Whole string parsed, in range
+static bool parse(char const * s, long & value)
+{
+    char * end;
+    errno = 0;
+    value = std::strtol(s, &end, 10);
+    return end != s && !*end && errno == 0;
+}
+
+static bool parse(char const * s, double & value)
+{
+    char * end;
+    errno = 0;
+    value = std::strtod(s, &end);
+    return end != s && !*end && errno == 0 && std::isfinite(value);
+}
+
+// Reads [uniform lo hi | normal mean stddev | file path] [samples] from
+// argv[i], false for an unknown keyword, a malformed number, a non-positive
+// sample count or extra arguments
+static bool parse_inputs(int argc, char ** argv, int i, Bench::Distribution & d, std::size_t & samples)
+{
+    double a, b;
+    if(argc > i && (!strcmp(argv[i], "uniform") || !strcmp(argv[i], "normal")))
+    {
+        bool uniform = !strcmp(argv[i], "uniform");
+        if(argc < i + 3 || !parse(argv[i + 1], a) || !parse(argv[i + 2], b)) return false;
+        if(uniform ? !(a < b) : !(b > 0.0)) return false;
+        d = { uniform ? Bench::Distribution::UNIFORM : Bench::Distribution::NORMAL, a, b, "" };
+        i += 3;
+    }
+    else if(argc > i && !strcmp(argv[i], "file"))
+    {
+        if(argc < i + 2) return false;
+        d = { Bench::Distribution::FILE, 0.0, 0.0, argv[i + 1] };
+        i += 2;
+    }
+
+    if(argc > i)
+    {
+        long n;
+        if(!parse(argv[i], n) || n <= 0) return false;
+        samples = static_cast<std::size_t>(n);
+        ++i;
+    }
+    return argc == i;
+}
+
+int main(int argc, char ** argv)
+{
+    bool sweep = argc > 1 && !strcmp(argv[1], "sweep");
+    if(sweep) --argc, ++argv;
+
+    long n;
+    if(argc > 2 && parse(argv[2], n) && n > 0)
+    {
+        std::string function = argv[1];
+        Bench::Distribution d = default_distribution(function);
+        std::size_t samples = sweep ? 65536 : 4096;
+
+        if(!parse_inputs(argc, argv, 3, d, samples))
+        {
+            std::cout << "Bad inputs: unknown distribution, malformed number or non-positive samples" << std::endl;
+        }
+        else if(sweep)
+        {
+            std::cout << "Sweeping " << function << " over " << samples << " inputs : \n" << std::endl;
+            if(Sweep::sweep(function, n, d, samples))
+                return 0;
+        }
+        else
+        {
+            std::cout << "Computing " << n << " times " << function << " per variant : \n" << std::endl;
+            if(Bench::benchmark(function, n, d, samples))
+                return 0;
+        }
+    }
+    std::cout << "./bench [sweep] <cos|exp|pow|factorial> <loop_count> "
+                 "[uniform <lo> <hi> | normal <mean> <stddev> | file <path>] [samples]" << std::endl;
+    return 1;
+}
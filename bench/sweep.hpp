@@ -0,0 +1,279 @@
+#ifndef SWEEP_HPP
+#define SWEEP_HPP
+
+#include "bench.hpp"
+#include "../table/table.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Accuracy versus speed: every variant and order over a dense set of inputs,
+// with the max and RMS error in ULP against a long double reference and the
+// throughput in ns per call, reduced to the Pareto-optimal configurations
+// (no other one is both faster and more accurate).
+
+namespace Sweep {
+
+    struct Config
+    {
+        std::string name;
+        double max_ulp;
+        double rms_ulp;
+        double ns;
+    };
+
+    // |y - reference| in units of the last place of the reference rounded to
+    // double, against the long double reference itself: a correctly rounded
+    // result is up to 0.5 ulp off, not 0
+    inline double ulps(double y, long double reference)
+    {
+        double r = static_cast<double>(reference);
+        if(y == reference || (std::isinf(y) && y == r)) return 0.0;
+        if(std::isnan(y) || std::isinf(y) || std::isinf(r))
+            return std::numeric_limits<double>::infinity();
+        double a = std::fabs(r);
+        double ulp = std::nextafter(a, std::numeric_limits<double>::infinity()) - a;
+        return static_cast<double>(std::fabs(y - reference) / ulp);
+    }
+
+    template <typename F, typename R>
+    void measure(std::string const & name, F f, R reference, std::vector<double> const & xs,
+                 long n, double & sink, std::vector<Config> & configs)
+    {
+        Config c = { name, 0.0, 0.0, 0.0 };
+        for(double x : xs)
+        {
+            double u = ulps(f(x), reference(x));
+            c.max_ulp = std::max(c.max_ulp, u);
+            c.rms_ulp += u * u;
+        }
+        c.rms_ulp = xs.empty() ? 0.0 : std::sqrt(c.rms_ulp / xs.size());
+        c.ns = Bench::throughput(f, xs, n, sink);
+        configs.push_back(c);
+    }
+
+    inline std::string name(char const * prefix, int order, char const * suffix)
+    {
+        std::ostringstream os;
+        os << prefix << order << suffix;
+        return os.str();
+    }
+
+    // One configuration per order of the template function F<N>
+    template <template <int> class F, typename R>
+    void template_orders(char const *, R, std::vector<double> const &, long, double &,
+                         std::vector<Config> &)
+    {
+    }
+
+    template <template <int> class F, typename R, int N, int... Ns>
+    void template_orders(char const * prefix, R reference, std::vector<double> const & xs,
+                         long n, double & sink, std::vector<Config> & configs)
+    {
+        measure(name(prefix, N, ">"), F<N>(), reference, xs, n, sink, configs);
+        template_orders<F, R, Ns...>(prefix, reference, xs, n, sink, configs);
+    }
+
+//==============================================================================
+// Variants
+//==============================================================================
+
+    template <int N>
+    struct CosFunc
+    {
+        double operator()(double x) const { return RecursiveTemplateFunc::Cos<N>(x); }
+    };
+
+    // Q31 CORDIC with N steps
+    template <int N>
+    struct CordicFunc
+    {
+        double operator()(double x) const
+        {
+            return FixedPoint::ToDouble(Cordic::Cos<FixedPoint::Q31, N>(FixedPoint::Phase(x)));
+        }
+    };
+
+    // Compact tables over [0, 2pi), the input folded by parity and period
+    inline double turn(double x)
+    {
+        return std::fmod(std::fabs(x), 2.0 * M_PI);
+    }
+
+    static std::size_t const COMPACT_TABLE_SIZE = 4096u;
+
+    template <int N>
+    struct ExpFunc
+    {
+        double operator()(double x) const { return RecursiveTemplateFunc::Exp<N>(x); }
+    };
+
+    inline void cos(std::vector<double> const & xs, long n, double & sink, std::vector<Config> & configs)
+    {
+        auto reference = [](double x) { return std::cos(static_cast<long double>(x)); };
+        measure("std::cos", [](double x) { return std::cos(x); }, reference, xs, n, sink, configs);
+        for(int order = 4; order <= 16; order += 2)
+        {
+            measure(name("Normal::Cos(x, ", order, ")"), [=](double x) { return Normal::Cos(x, order); },
+                    reference, xs, n, sink, configs);
+            measure(name("Inline::Cos(x, ", order, ")"), [=](double x) { return Inline::Cos(x, order); },
+                    reference, xs, n, sink, configs);
+            measure(name("Constexpr::Cos(x, ", order, ")"), [=](double x) { return Constexpr::Cos(x, order); },
+                    reference, xs, n, sink, configs);
+        }
+        template_orders<CosFunc, decltype(reference), 4, 6, 8, 10, 12, 14, 16>(
+            "RecursiveTemplateFunc::Cos<", reference, xs, n, sink, configs);
+        measure("CompileTimeArray::cosinus", [](double x) {
+            return CompileTimeArray::cosinus[Bench::index(std::fabs(x) / TO_RAD, COS_ARRAY_SIZE)]; },
+            reference, xs, n, sink, configs);
+        measure("ShallowCompileTimeArray::cosinus", [](double x) {
+            return ShallowCompileTimeArray::cosinus[Bench::index(std::fabs(x) / TO_RAD, COS_ARRAY_SIZE)]; },
+            reference, xs, n, sink, configs);
+
+        measure("FixedPointTable::Cos<Q15>", [](double x) {
+            return FixedPoint::ToDouble(FixedPointTable::Cos<FixedPoint::Q15>(FixedPoint::Phase(x))); },
+            reference, xs, n, sink, configs);
+        measure("FixedPointTable::Cos<Q31>", [](double x) {
+            return FixedPoint::ToDouble(FixedPointTable::Cos<FixedPoint::Q31>(FixedPoint::Phase(x))); },
+            reference, xs, n, sink, configs);
+        measure("Cordic::Cos<Q15, 16>", [](double x) {
+            return FixedPoint::ToDouble(Cordic::Cos<FixedPoint::Q15, 16>(FixedPoint::Phase(x))); },
+            reference, xs, n, sink, configs);
+        template_orders<CordicFunc, decltype(reference), 8, 12, 16, 20, 24, 28, 30, 32, 40>(
+            "Cordic::Cos<Q31, ", reference, xs, n, sink, configs);
+
+        auto cos_func = [](double x) { return std::cos(x); };
+        CompactTable::ValueTable<float> value(cos_func, 0.0, 2.0 * M_PI, COMPACT_TABLE_SIZE);
+        CompactTable::LerpTable<float> lerp(cos_func, 0.0, 2.0 * M_PI, COMPACT_TABLE_SIZE);
+        CompactTable::LerpTable<CompactTable::Half> half_lerp(cos_func, 0.0, 2.0 * M_PI, COMPACT_TABLE_SIZE);
+        CompactTable::SinCosTable<float> sincos(COMPACT_TABLE_SIZE);
+        CompactTable::SinCosTable<CompactTable::Half> half_sincos(COMPACT_TABLE_SIZE);
+        measure("CompactTable::ValueTable<float>", [&](double x) { return value(turn(x)); },
+                reference, xs, n, sink, configs);
+        measure("CompactTable::LerpTable<float>", [&](double x) { return lerp(turn(x)); },
+                reference, xs, n, sink, configs);
+        measure("CompactTable::LerpTable<Half>", [&](double x) { return half_lerp(turn(x)); },
+                reference, xs, n, sink, configs);
+        measure("CompactTable::SinCosTable<float>", [&](double x) {
+            double s, c; sincos(turn(x), s, c); return c; }, reference, xs, n, sink, configs);
+        measure("CompactTable::SinCosTable<Half>", [&](double x) {
+            double s, c; half_sincos(turn(x), s, c); return c; }, reference, xs, n, sink, configs);
+    }
+
+    inline void exp(std::vector<double> const & xs, long n, double & sink, std::vector<Config> & configs)
+    {
+        auto reference = [](double x) { return std::exp(static_cast<long double>(x)); };
+        measure("std::exp", [](double x) { return std::exp(x); }, reference, xs, n, sink, configs);
+        for(int order = 8; order <= 32; order += 4)
+        {
+            measure(name("Normal::Exp(x, ", order, ")"), [=](double x) { return Normal::Exp(x, order); },
+                    reference, xs, n, sink, configs);
+            measure(name("Inline::Exp(x, ", order, ")"), [=](double x) { return Inline::Exp(x, order); },
+                    reference, xs, n, sink, configs);
+            measure(name("Constexpr::Exp(x, ", order, ")"), [=](double x) { return Constexpr::Exp(x, order); },
+                    reference, xs, n, sink, configs);
+        }
+        template_orders<ExpFunc, decltype(reference), 8, 12, 16, 20, 24, 28, 32>(
+            "RecursiveTemplateFunc::Exp<", reference, xs, n, sink, configs);
+        measure("CompileTimeArray::exponentials", [](double x) {
+            double e = CompileTimeArray::exponentials[Bench::index(std::fabs(x), EXP_ARRAY_SIZE)];
+            return x < 0.0 ? 1.0 / e : e; }, reference, xs, n, sink, configs);
+        measure("ShallowCompileTimeArray::exponentials", [](double x) {
+            double e = ShallowCompileTimeArray::exponentials[Bench::index(std::fabs(x), EXP_ARRAY_SIZE)];
+            return x < 0.0 ? 1.0 / e : e; }, reference, xs, n, sink, configs);
+    }
+
+    // x^10: no order, the variants differ by their code only
+    inline void pow(std::vector<double> const & xs, long n, double & sink, std::vector<Config> & configs)
+    {
+        auto reference = [](double x) { return std::pow(static_cast<long double>(x), 10); };
+        measure("std::pow", [](double x) { return std::pow(x, 10); }, reference, xs, n, sink, configs);
+        measure("Normal::Pow(x, 10)", [](double x) { return Normal::Pow(x, 10); }, reference, xs, n, sink, configs);
+        measure("Inline::Pow(x, 10)", [](double x) { return Inline::Pow(x, 10); }, reference, xs, n, sink, configs);
+        measure("RecursiveTemplateFunc::Pow<10>", [](double x) { return RecursiveTemplateFunc::Pow<10>(x); },
+                reference, xs, n, sink, configs);
+        measure("Constexpr::Pow(x, 10)", [](double x) { return Constexpr::Pow(x, 10); }, reference, xs, n, sink, configs);
+    }
+
+    // Factorial of the nearest integer in [0, 170]
+    inline void factorial(std::vector<double> const & xs, long n, double & sink, std::vector<Config> & configs)
+    {
+        auto reference = [](double x) {
+            long double f = 1.0L;
+            for(int i = 2; i <= Bench::index(x, 171); ++i) f *= i;
+            return f;
+        };
+        measure("std::tgamma", [](double x) { return std::tgamma(Bench::index(x, 171) + 1.0); },
+                reference, xs, n, sink, configs);
+        measure("Normal::Factorial", [](double x) { return Normal::Factorial(Bench::index(x, 171)); },
+                reference, xs, n, sink, configs);
+        measure("Inline::Factorial", [](double x) { return Inline::Factorial(Bench::index(x, 171)); },
+                reference, xs, n, sink, configs);
+        measure("Constexpr::Factorial", [](double x) { return Constexpr::Factorial(Bench::index(x, 171)); },
+                reference, xs, n, sink, configs);
+        measure("CompileTimeArray::factorials", [](double x) {
+            return CompileTimeArray::factorials[Bench::index(x, 171)]; }, reference, xs, n, sink, configs);
+        measure("ShallowCompileTimeArray::factorials", [](double x) {
+            return ShallowCompileTimeArray::factorials[Bench::index(x, 171)]; }, reference, xs, n, sink, configs);
+    }
+
+//==============================================================================
+// Report
+//==============================================================================
+
+    // Sorted by time, the configurations more accurate than all the faster ones
+    inline std::vector<Config> pareto(std::vector<Config> configs)
+    {
+        std::sort(configs.begin(), configs.end(), [](Config const & a, Config const & b) {
+            return a.ns < b.ns || (a.ns == b.ns && a.max_ulp < b.max_ulp);
+        });
+        std::vector<Config> frontier;
+        for(Config const & c : configs)
+            if(frontier.empty() || c.max_ulp < frontier.back().max_ulp)
+                frontier.push_back(c);
+        return frontier;
+    }
+
+    inline void print(std::vector<Config> const & configs)
+    {
+        std::cout << std::setw(38) << std::left << "" << std::right << std::setw(12) << "max ulp"
+                  << std::setw(12) << "rms ulp" << std::setw(12) << "ns" << std::endl;
+        for(Config const & c : configs)
+            std::cout << std::setw(38) << std::left << c.name << std::right
+                      << std::setw(12) << std::setprecision(3) << std::defaultfloat << c.max_ulp
+                      << std::setw(12) << c.rms_ulp
+                      << std::setw(12) << std::fixed << std::setprecision(2) << c.ns << std::endl;
+    }
+
+    // Returns false for an unknown function or an unreadable file
+    inline bool sweep(std::string const & function, long n, Bench::Distribution const & d,
+                      std::size_t samples)
+    {
+        std::vector<double> xs;
+        if(!Bench::inputs(d, samples, xs)) return false;
+
+        double sink = 0.0;
+        std::vector<Config> configs;
+        if(function == "cos") cos(xs, n, sink, configs);
+        else if(function == "exp") exp(xs, n, sink, configs);
+        else if(function == "pow") pow(xs, n, sink, configs);
+        else if(function == "factorial") factorial(xs, n, sink, configs);
+        else return false;
+
+        std::cout << "All configurations:" << std::endl;
+        print(configs);
+        std::cout << std::endl << "Pareto frontier (by max ulp):" << std::endl;
+        print(pareto(configs));
+        std::cout << std::endl << "(" << std::defaultfloat << sink << ")" << std::endl;
+        return true;
+    }
+
+}
+
+#endif //SWEEP_HPP
@@ -0,0 +1,405 @@
+#ifndef COMBINATORICS_HPP
+#define COMBINATORICS_HPP
+
+#include "../factorial/factorial.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <limits>
+
+// Binomial coefficients and multinomials without factorial ratios: the
+// doubles overflow past 170!, so Factorial(n) / (Factorial(k) * Factorial(n - k))
+// is inf / inf for n > 170 and inexact well before.
+//
+//  * Exact: constexpr Pascal triangle in uint64_t, up to the last row that
+//    fits (67).
+//  * Large n: log-factorial table and Stirling series, exp'd only at the end
+//    so that the result overflows only if it really does not fit in a double.
+
+//==============================================================================
+// Compile-time index sequence (std::index_sequence is C++14)
+//==============================================================================
+namespace Indices {
+
+    template <std::size_t... I>
+    struct Sequence
+    {
+        static std::size_t const size = sizeof...(I);
+    };
+
+    template <typename L, typename R>
+    struct Concat;
+
+    template <std::size_t... L, std::size_t... R>
+    struct Concat<Sequence<L...>, Sequence<R...>>
+    {
+        typedef Sequence<L..., (sizeof...(L) + R)...> type;
+    };
+
+    // 0, 1, ..., N - 1, built by halves: logarithmic instantiation depth
+    template <std::size_t N>
+    struct Make
+    {
+        typedef typename Concat<typename Make<N / 2>::type,
+                                typename Make<N - N / 2>::type>::type type;
+    };
+
+    template <>
+    struct Make<0>
+    {
+        typedef Sequence<> type;
+    };
+
+    template <>
+    struct Make<1>
+    {
+        typedef Sequence<0> type;
+    };
+
+}
+
+//==============================================================================
+// Constexpr binomial coefficients
+//==============================================================================
+namespace Constexpr {
+
+    constexpr std::uint64_t Gcd(std::uint64_t a, std::uint64_t b)
+    {
+        return b == 0 ? a : Gcd(b, a % b);
+    }
+
+    // C(n, k) = C(n - 1, k - 1) * n / k. With g = gcd(C(n - 1, k - 1), k),
+    // k / g divides n, so no intermediate is larger than the result.
+    constexpr std::uint64_t BinomialStep(std::uint64_t c, std::uint64_t n,
+                                         std::uint64_t k, std::uint64_t g)
+    {
+        return (c / g) * (n / (k / g));
+    }
+
+    constexpr std::uint64_t BinomialFrom(std::uint64_t c, int n, int k)
+    {
+        return BinomialStep(c, n, k, Gcd(c, k));
+    }
+
+    constexpr std::uint64_t Binomial(int n, int k)
+    {
+        return k < 0 || k > n ? 0 : k == 0 ? 1 :
+            BinomialFrom(Binomial(n - 1, k - 1), n, k);
+    }
+
+}
+
+//==============================================================================
+// Compile-time Pascal triangle
+//==============================================================================
+
+// C(67, k) is the last row that fits in 64 bits
+static int const PASCAL_ROWS = 68;
+
+namespace CompileTimeArray {
+
+    // Row n starts at index n * (n + 1) / 2
+    constexpr std::size_t PascalRow(std::size_t i, std::size_t n = 0)
+    {
+        return i < (n + 1) * (n + 2) / 2 ? n : PascalRow(i, n + 1);
+    }
+
+    constexpr std::size_t PascalCol(std::size_t i)
+    {
+        return i - PascalRow(i) * (PascalRow(i) + 1) / 2;
+    }
+
+    template <typename Seq>
+    struct PascalTable;
+
+    template <std::size_t... I>
+    struct PascalTable<Indices::Sequence<I...>>
+    {
+        static constexpr std::uint64_t array[sizeof...(I)] = {
+            Constexpr::Binomial(static_cast<int>(PascalRow(I)),
+                                static_cast<int>(PascalCol(I)))...
+        };
+    };
+
+    template <std::size_t... I>
+    constexpr std::uint64_t PascalTable<Indices::Sequence<I...>>::array[sizeof...(I)];
+
+    typedef PascalTable<Indices::Make<PASCAL_ROWS * (PASCAL_ROWS + 1) / 2>::type> Pascal;
+
+    static std::uint64_t const * pascal = Pascal::array;
+
+}
+
+//==============================================================================
+// Log-factorial table
+//==============================================================================
+static std::size_t const LOG_FACT_ARRAY_SIZE = 1024u; // 8KB, stays in L1
+
+namespace CompileTimeArray {
+
+    template <int N>
+    struct LogFactorialTable
+    {
+        static double array[N];
+
+        static bool const filled;
+
+        static bool fill()
+        {
+            for(int i = 0; i < N; ++i)
+                array[i] = std::lgamma(i + 1.0);
+            return true;
+        }
+    };
+
+    template <int N>
+    double LogFactorialTable<N>::array[N];
+
+    template <int N>
+    bool const LogFactorialTable<N>::filled = LogFactorialTable<N>::fill();
+
+    template struct LogFactorialTable<LOG_FACT_ARRAY_SIZE>;
+
+    static double const * log_factorials = LogFactorialTable<LOG_FACT_ARRAY_SIZE>::array;
+
+}
+
+//==============================================================================
+// O(1) lookups
+//==============================================================================
+namespace Combinatorics {
+
+    // log(n!), table below LOG_FACT_ARRAY_SIZE, Stirling series above (the
+    // first neglected term is below 2^-53 relative there). +inf for n < 0
+    // (the poles of Gamma).
+    inline double LogFactorial(int n)
+    {
+        if(n < 0) return std::numeric_limits<double>::infinity();
+        if(n < static_cast<int>(LOG_FACT_ARRAY_SIZE))
+            return CompileTimeArray::log_factorials[n];
+
+        double x = n;
+        double inv = 1.0 / x;
+        double inv2 = inv * inv;
+        return x * std::log(x) - x + 0.5 * std::log(2.0 * M_PI * x) +
+               inv * (1.0 / 12.0 - inv2 * (1.0 / 360.0 - inv2 * (1.0 / 1260.0)));
+    }
+
+    // log(Gamma(n)) for positive integers, +inf for n <= 0
+    inline double LogGamma(int n)
+    {
+        return LogFactorial(n - 1);
+    }
+
+    inline double LogBinomial(int n, int k)
+    {
+        return k < 0 || k > n ? -std::numeric_limits<double>::infinity() :
+               LogFactorial(n) - LogFactorial(k) - LogFactorial(n - k);
+    }
+
+    // Exact C(n, k), n < PASCAL_ROWS. 0 outside of the table too (n < 0 or
+    // n >= PASCAL_ROWS): ChooseExact for larger n.
+    inline std::uint64_t Choose(int n, int k)
+    {
+        return k < 0 || k > n || n >= PASCAL_ROWS ? 0 :
+               CompileTimeArray::pascal[n * (n + 1) / 2 + k];
+    }
+
+    // Exact C(n, k) for any n, false if it does not fit in 64 bits. O(1) in
+    // the table, O(min(k, n - k)) above it.
+    inline bool ChooseExact(int n, int k, std::uint64_t & result)
+    {
+        if(k < 0 || k > n) { result = 0; return true; }
+        if(n < PASCAL_ROWS) { result = Choose(n, k); return true; }
+
+        if(k > n - k) k = n - k;
+        std::uint64_t c = 1;
+        for(int i = 1; i <= k; ++i)
+        {
+            // c * (n - k + i) / i, exact thanks to the gcd
+            std::uint64_t m = static_cast<std::uint64_t>(n - k + i);
+            std::uint64_t g = Constexpr::Gcd(c, i);
+            std::uint64_t a = c / g;
+            std::uint64_t b = m / (i / g);
+            if(a > std::numeric_limits<std::uint64_t>::max() / b) return false;
+            c = a * b;
+        }
+        result = c;
+        return true;
+    }
+
+    // C(n, k) as a double: exact up to the last row of the table, rounded
+    // from the log-factorials above. inf only if it exceeds DBL_MAX.
+    inline double Binomial(int n, int k)
+    {
+        if(k < 0 || k > n) return 0.0;
+        if(n < PASCAL_ROWS) return static_cast<double>(Choose(n, k));
+        return std::round(std::exp(LogBinomial(n, k)));
+    }
+
+    // (k1 + ... + km)! / (k1! ... km!), -inf (log 0) if a k is negative
+    inline double LogMultinomial(std::initializer_list<int> ks)
+    {
+        int n = 0;
+        double r = 0.0;
+        for(int k : ks)
+        {
+            if(k < 0) return -std::numeric_limits<double>::infinity();
+            n += k;
+            r -= LogFactorial(k);
+        }
+        return r + LogFactorial(n);
+    }
+
+    inline double Multinomial(std::initializer_list<int> ks)
+    {
+        return std::round(std::exp(LogMultinomial(ks)));
+    }
+
+    // Exact multinomial as a product of binomials:
+    // C(k1, k1) * C(k1 + k2, k2) * ... * C(k1 + ... + km, km)
+    inline bool MultinomialExact(std::initializer_list<int> ks, std::uint64_t & result)
+    {
+        int n = 0;
+        std::uint64_t r = 1;
+        for(int k : ks)
+        {
+            n += k;
+            std::uint64_t c;
+            if(!ChooseExact(n, k, c)) return false;
+            if(c != 0 && r > std::numeric_limits<std::uint64_t>::max() / c) return false;
+            r *= c;
+        }
+        result = r;
+        return true;
+    }
+
+}
+
+//==============================================================================
+// Minimalist benchmark
+//==============================================================================
+namespace Combinatorics {
+
+    // Factorial-ratio approach. The factorials past the table overflow as
+    // those past 170 in it do. 0 for k outside of [0, n], as Choose.
+    inline double FactorialRatio(int n, int k)
+    {
+        if(k < 0 || k > n) return 0.0;
+        double const * f = CompileTimeArray::factorials;
+        int const size = static_cast<int>(FACT_ARRAY_SIZE);
+        double const inf = std::numeric_limits<double>::infinity();
+        return (n < size ? f[n] : inf) /
+               ((k < size ? f[k] : inf) * (n - k < size ? f[n - k] : inf));
+    }
+
+    void print_binomial(int n, int k)
+    {
+        std::uint64_t exact = 0;
+        bool fits = ChooseExact(n, k, exact);
+
+        std::cout << "C(" << n << ", " << k << ") : ratio " << FactorialRatio(n, k)
+                  << ", Binomial " << Binomial(n, k) << ", exact ";
+        if(fits) std::cout << exact; else std::cout << "(overflow)";
+        std::cout << std::endl;
+    }
+
+    // (n, k) pairs in [0, max_n), varying enough for the loop not to fold.
+    // One 64-bit LCG step per draw, of which the high 32 bits (the low bits
+    // of an LCG have short periods): k uniform in [0, n] for any n.
+    template <typename F>
+    double time_pairs(F f, int max_n, int loops, double & sink)
+    {
+        double sum = 0.0;
+        std::uint64_t r = 12345u;
+        auto start = std::chrono::high_resolution_clock::now();
+        for(int i = 0; i < loops; ++i)
+        {
+            r = r * 6364136223846793005ull + 1442695040888963407ull;
+            int n = static_cast<int>((r >> 32) % static_cast<unsigned>(max_n));
+            r = r * 6364136223846793005ull + 1442695040888963407ull;
+            int k = static_cast<int>((r >> 32) % static_cast<unsigned>(n + 1));
+            sum += f(n, k);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        sink += sum;
+        return std::chrono::duration<double, std::nano>(end - start).count() / loops;
+    }
+
+    void benchmark(int n)
+    {
+        print_binomial(30, 15);
+        print_binomial(60, 30);
+        print_binomial(67, 33);
+        print_binomial(100, 3);
+        print_binomial(200, 100);
+        print_binomial(1000, 500);
+        print_binomial(2000, 1000);
+
+        std::uint64_t m = 0;
+        bool fits = MultinomialExact({ 10, 10, 10 }, m);
+        std::cout << "Multinomial(10, 10, 10) : ratio "
+                  << CompileTimeArray::factorials[30] /
+                     std::pow(CompileTimeArray::factorials[10], 3)
+                  << ", Multinomial " << Multinomial({ 10, 10, 10 }) << ", exact ";
+        if(fits) std::cout << m; else std::cout << "(overflow)";
+        std::cout << std::endl;
+        std::cout << "LogMultinomial(300, 300, 300) : "
+                  << LogMultinomial({ 300, 300, 300 }) << std::endl;
+
+        // Exact whenever the value is representable (below 2^53)
+        int wrong = 0, representable = 0;
+        for(int i = 0; i < PASCAL_ROWS; ++i)
+        {
+            for(int j = 0; j <= i; ++j)
+            {
+                if(Choose(i, j) > (1ull << 53)) continue;
+                ++representable;
+                wrong += FactorialRatio(i, j) != static_cast<double>(Choose(i, j));
+            }
+        }
+        std::cout << "Factorial ratio wrong for " << wrong << " of the "
+                  << representable << " C(n < 68, k) below 2^53" << std::endl;
+        std::cout << "k outside of [0, n] : ratio " << FactorialRatio(5, 7) << " "
+                  << FactorialRatio(5, -1) << " " << FactorialRatio(-1, 0) << ", Choose "
+                  << Choose(5, 7) << " " << Choose(5, -1) << " " << Choose(-1, 0) << std::endl;
+        std::cout << std::endl;
+
+        double sink = 0.0;
+
+        std::cout << "n < 68 (ns per call):" << std::endl;
+        std::cout << "Factorial ratio (array) : " << time_pairs(
+            [](int n, int k) { return FactorialRatio(n, k); }, PASCAL_ROWS, n, sink) << "ns" << std::endl;
+        std::cout << "Factorial ratio (Inline) : " << time_pairs(
+            [](int n, int k) { return Inline::Factorial(n) / (Inline::Factorial(k) *
+                                      Inline::Factorial(n - k)); }, PASCAL_ROWS, n, sink) << "ns" << std::endl;
+        std::cout << "Choose (exact table) : " << time_pairs(
+            [](int n, int k) { return static_cast<double>(Choose(n, k)); }, PASCAL_ROWS, n, sink) << "ns" << std::endl;
+        std::cout << "Binomial : " << time_pairs(
+            [](int n, int k) { return Binomial(n, k); }, PASCAL_ROWS, n, sink) << "ns" << std::endl;
+        std::cout << std::endl;
+
+        std::cout << "n < 170 (ns per call):" << std::endl;
+        std::cout << "Factorial ratio (array) : " << time_pairs(
+            [](int n, int k) { return FactorialRatio(n, k); }, 170, n, sink) << "ns" << std::endl;
+        std::cout << "Binomial : " << time_pairs(
+            [](int n, int k) { return Binomial(n, k); }, 170, n, sink) << "ns" << std::endl;
+        std::cout << "LogBinomial : " << time_pairs(
+            [](int n, int k) { return LogBinomial(n, k); }, 170, n, sink) << "ns" << std::endl;
+        std::cout << std::endl;
+
+        std::cout << "n < 100000 (ns per call, the ratio overflows):" << std::endl;
+        std::cout << "Binomial : " << time_pairs(
+            [](int n, int k) { return Binomial(n, k); }, 100000, n, sink) << "ns" << std::endl;
+        std::cout << "LogBinomial : " << time_pairs(
+            [](int n, int k) { return LogBinomial(n, k); }, 100000, n, sink) << "ns" << std::endl;
+
+        std::cout << std::endl << "(" << sink << ")" << std::endl;
+    }
+
+}
+
+#endif //COMBINATORICS_HPP
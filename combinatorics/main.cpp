@@ -0,0 +1,17 @@
+#include <iostream>
+
+#include "combinatorics.hpp"
+
+int main(int argc, char ** argv)
+{
+    if(argc > 1)
+    {
+        std::cout << "Computing " << atoi(argv[1]) << " times random C(n, k) : \n" << std::endl;
+        Combinatorics::benchmark(atoi(argv[1]));
+    }
+    else
+    {
+        std::cout << "./combinatorics <loop_count>" << std::endl;
+    }
+    return 0;
+}
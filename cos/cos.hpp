@@ -3,10 +3,16 @@
 
 #include "../pow/pow.hpp"
 #include "../factorial/factorial.hpp"
+#include "../profile/profile.hpp"
 
-#include <iostream>
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <type_traits>
 
 static double constexpr TO_RAD = M_PI / 180.0;
 
@@ -17,10 +23,16 @@ static double constexpr TO_RAD = M_PI / 180.0;
 //==============================================================================
 namespace Normal {
 
+    double Cos_(double x, int n)
+    {
+        return n == 0 ? 1.0 : Cos_(x, n - 1) + (n % 2 ? -1.0 : 1.0) *
+            Pow_(x, 2 * n) / Factorial_(2 * n);
+    }
+
     double Cos(double x, int n)
     {
-        return n == 0 ? 1.0 : Cos(x, n - 1) + (n % 2 ? -1.0 : 1.0) *
-            Pow(x, 2 * n) / Factorial(2 * n);
+        TMP_PROFILE_SCOPE("Normal::Cos", n);
+        return Cos_(x, n);
     }
 
 }
@@ -29,10 +41,16 @@ namespace Normal {
 //==============================================================================
 namespace Inline {
 
+    inline double Cos_(double x, int n)
+    {
+        return n == 0 ? 1.0 : Cos_(x, n - 1) + (n % 2 ? -1.0 : 1.0) *
+            Pow_(x, 2 * n) / Factorial_(2 * n);
+    }
+
     inline double Cos(double x, int n)
     {
-        return n == 0 ? 1.0 : Cos(x, n - 1) + (n % 2 ? -1.0 : 1.0) *
-            Pow(x, 2 * n) / Factorial(2 * n);
+        TMP_PROFILE_SCOPE("Inline::Cos", n);
+        return Cos_(x, n);
     }
 
 }
@@ -43,17 +61,24 @@ namespace Inline {
 namespace RecursiveTemplateFunc {
 
     template <int N>
-    inline double Cos(double x)
+    inline double Cos_(double x)
     {
-        return Cos<N - 1>(x) + (N % 2 ? -1.0 : 1.0) * Pow<2 * N>(x) /
-            Factorial<2 * N>();
+        return Cos_<N - 1>(x) + (N % 2 ? -1.0 : 1.0) * Pow_<2 * N>(x) /
+            Factorial_<2 * N>();
     }
 
     template <>
-    inline double Cos<0>(double)
+    inline double Cos_<0>(double)
     {
         return 1.0;
     }
+
+    template <int N>
+    inline double Cos(double x)
+    {
+        TMP_PROFILE_SCOPE("RecursiveTemplateFunc::Cos", N);
+        return Cos_<N>(x);
+    }
 }
 
 //==============================================================================
@@ -81,15 +106,83 @@ namespace RecursiveTemplateStruct {
     double const Cos<X, 0>::Value = 1.0;
 
 }
+//==============================================================================
+// Shallow recursive struct cosinus: logarithmic instantiation depth
+//==============================================================================
+namespace ShallowTemplateStruct {
+
+    // Terms of the series from the ratio of consecutive terms,
+    // -x^2 / ((2I - 1) 2I) with x = X * TO_RAD, instead of one pow and one
+    // Factorial<2I> per term, over [Lo, Hi] split in halves at M (see ExpSum):
+    //
+    //     Sum = Sum[Lo, M] + Ratio[Lo, M] * Sum[M + 1, Hi]
+    //
+    // The additions are nested from the right instead of left to right: the
+    // result can differ from RecursiveTemplateStruct in the last bits.
+    template <int X, int Lo, int Hi>
+    struct CosSum
+    {
+        static const double Ratio;
+        static const double Sum;
+    };
+
+    template <int X, int Lo, int Hi>
+    double const CosSum<X, Lo, Hi>::Ratio = CosSum<X, Lo, (Lo + Hi) / 2>::Ratio *
+                                            CosSum<X, (Lo + Hi) / 2 + 1, Hi>::Ratio;
+
+    template <int X, int Lo, int Hi>
+    double const CosSum<X, Lo, Hi>::Sum = CosSum<X, Lo, (Lo + Hi) / 2>::Sum +
+                                          CosSum<X, Lo, (Lo + Hi) / 2>::Ratio *
+                                          CosSum<X, (Lo + Hi) / 2 + 1, Hi>::Sum;
+
+    template <int X, int I>
+    struct CosSum<X, I, I>
+    {
+        static const double Ratio;
+        static const double Sum;
+    };
+
+    template <int X, int I>
+    double const CosSum<X, I, I>::Ratio = -(X * TO_RAD) * (X * TO_RAD) /
+                                          ((2.0 * I - 1.0) * (2.0 * I));
+
+    template <int X, int I>
+    double const CosSum<X, I, I>::Sum = CosSum<X, I, I>::Ratio;
+
+    template <int X, int N>
+    struct Cos
+    {
+        static const double Value;
+    };
+
+    template <int X, int N>
+    double const Cos<X, N>::Value = 1.0 + CosSum<X, 1, N>::Sum;
+
+    template <int X>
+    struct Cos<X, 0>
+    {
+        static const double Value;
+    };
+
+    template <int X>
+    double const Cos<X, 0>::Value = 1.0;
+
+}
+
 //==============================================================================
 // Constexpr Function cosinus
 //==============================================================================
 namespace Constexpr {
 
+    constexpr double Cos_(double x, int n)
+    {
+        return n == 0 ? 1.0 : Cos_(x, n - 1) + Pow_(-1, n) * Pow_(x, 2 * n) /
+            Factorial_(2 * n);
+    }
+
     constexpr double Cos(double x, int n)
-    { 
-        return n == 0 ? 1.0 : Cos(x, n - 1) + Pow(-1, n) * Pow(x, 2 * n) /
-            Factorial(2 * n);
+    {
+        return TMP_PROFILE_COUNT("Constexpr::Cos", n), Cos_(x, n);
     }
 
 }
@@ -129,7 +222,341 @@ double CosTable<SIZE, 0>::array[SIZE] = { cos_func(0) };
 
 template struct CosTable<COS_ARRAY_SIZE>;
 
-static double const * cosinus = CosTable<COS_ARRAY_SIZE>::array;
+static auto const cosinus = TMP_PROFILE_TABLE("CompileTimeArray::cosinus", CosTable<COS_ARRAY_SIZE>::array);
+
+}
+
+//==============================================================================
+// Shallow compile-time generated array of cosinus
+//==============================================================================
+namespace ShallowCompileTimeArray {
+
+template <int SIZE>
+struct CosTable
+{
+    static double array[SIZE];
+
+    static bool const filled;
+};
+
+// array[N] = cos_func(N) for N in [Lo, Hi], split in halves down to blocks of 16
+template <int SIZE, int Lo, int Hi, bool Block = (Hi - Lo < 16)>
+struct CosFill
+{
+    static bool Do()
+    {
+        return CosFill<SIZE, Lo, (Lo + Hi) / 2>::Do() &&
+               CosFill<SIZE, (Lo + Hi) / 2 + 1, Hi>::Do();
+    }
+};
+
+template <int SIZE, int Lo, int Hi>
+struct CosFill<SIZE, Lo, Hi, true>
+{
+    static bool Do()
+    {
+        for(int n = Lo; n <= Hi; ++n)
+            CosTable<SIZE>::array[n] = CompileTimeArray::cos_func(n);
+        return true;
+    }
+};
+
+template <int SIZE>
+double CosTable<SIZE>::array[SIZE];
+
+template <int SIZE>
+bool const CosTable<SIZE>::filled = CosFill<SIZE, 0, SIZE - 1>::Do();
+
+template struct CosTable<COS_ARRAY_SIZE>;
+
+static auto const cosinus = TMP_PROFILE_TABLE("ShallowCompileTimeArray::cosinus", CosTable<COS_ARRAY_SIZE>::array);
+
+}
+
+//==============================================================================
+// Fixed-point cosinus (Q15/Q31), integer-only evaluation
+//==============================================================================
+// The angles are unsigned 32-bit phases: 2^32 is a full turn, so that the
+// range reduction is the natural wrap-around of the integer arithmetic.
+namespace FixedPoint {
+
+    typedef std::int16_t Q15;
+    typedef std::int32_t Q31;
+
+    template <typename Q> struct Format;
+
+    // Cordic is the CORDIC accumulator: int32 (Q30, which the compiler
+    // vectorizes across calls) is enough for Q15, Q31 needs int64 (Q62)
+    template <> struct Format<Q15>
+    {
+        typedef std::int32_t Wide;
+        typedef std::int32_t Cordic;
+        static int const bits = 15;
+    };
+
+    template <> struct Format<Q31>
+    {
+        typedef std::int64_t Wide;
+        typedef std::int64_t Cordic;
+        static int const bits = 31;
+    };
+
+    inline std::uint32_t Phase(double radians)
+    {
+        double turns = radians / (2.0 * M_PI);
+        turns -= std::floor(turns);
+        return static_cast<std::uint32_t>(static_cast<std::uint64_t>(turns * 4294967296.0));
+    }
+
+    template <typename Q>
+    inline double ToDouble(Q q)
+    {
+        return std::ldexp(static_cast<double>(q), -Format<Q>::bits);
+    }
+
+    template <typename Q, typename T>
+    inline Q Saturate(T w)
+    {
+        return w > std::numeric_limits<Q>::max() ? std::numeric_limits<Q>::max() :
+               w < std::numeric_limits<Q>::min() ? std::numeric_limits<Q>::min() :
+               static_cast<Q>(w);
+    }
+
+    // Q30 to Q, rounded and saturated
+    template <typename Q>
+    inline Q FromQ30(std::int32_t v)
+    {
+        typedef typename Format<Q>::Wide Wide;
+        int const shift = 30 - Format<Q>::bits;
+        return Saturate<Q>((static_cast<Wide>(v) + (Wide(1) << (shift - 1))) >> shift);
+    }
+
+    // Q62 to Q, rounded and saturated
+    template <typename Q>
+    inline Q FromQ62(std::int64_t v)
+    {
+        int const shift = 62 - Format<Q>::bits;
+        return Saturate<Q>((v + (std::int64_t(1) << (shift - 1))) >> shift);
+    }
+
+    // v in [-1, 1] to Q, rounded and saturated
+    template <typename Q>
+    inline Q FromDouble(double v)
+    {
+        return Saturate<Q>(std::floor(std::ldexp(v, Format<Q>::bits) + 0.5));
+    }
+
+}
+
+//==============================================================================
+// Fixed-point table cosinus: quarter-wave table, linear interpolation in Q15,
+// rotation from the nearest entry in Q31
+//==============================================================================
+static int const FIXED_COS_TABLE_BITS = 8;
+
+namespace FixedPointTable {
+
+    using namespace FixedPoint;
+
+    // cos over [0, pi/2] in 2^FIXED_COS_TABLE_BITS + 1 points. Filled with
+    // the Inline Taylor series (only IEEE +, *, /, no libm) so that the
+    // tables are the same on every platform.
+    template <typename Q>
+    struct QuarterCosTable
+    {
+        static int const SIZE = (1 << FIXED_COS_TABLE_BITS) + 1;
+
+        static Q array[SIZE];
+
+        static bool const filled;
+
+        static bool fill()
+        {
+            for(int i = 0; i < SIZE; ++i)
+            {
+                array[i] = FromDouble<Q>(Inline::Cos(i * (M_PI / 2.0) / (SIZE - 1), 20));
+            }
+            return true;
+        }
+    };
+
+    template <typename Q>
+    Q QuarterCosTable<Q>::array[QuarterCosTable<Q>::SIZE];
+
+    template <typename Q>
+    bool const QuarterCosTable<Q>::filled = QuarterCosTable<Q>::fill();
+
+    template struct QuarterCosTable<Q15>;
+    template struct QuarterCosTable<Q31>;
+
+    // cos over the quarter wave, t in [0, 2^30]
+    template <typename Q>
+    inline Q QuarterCos(std::uint32_t t)
+    {
+        typedef typename Format<Q>::Wide Wide;
+        // Enough fraction bits for the interpolation product to fit in Wide
+        int const frac_bits = Format<Q>::bits == 15 ? 14 : 30 - FIXED_COS_TABLE_BITS;
+
+        Q const * table = QuarterCosTable<Q>::array;
+        std::uint32_t i = t >> (30 - FIXED_COS_TABLE_BITS);
+        Wide frac = (t >> (30 - FIXED_COS_TABLE_BITS - frac_bits)) & ((Wide(1) << frac_bits) - 1);
+        if(i == QuarterCosTable<Q>::SIZE - 1) return table[i];
+        return static_cast<Q>(table[i] + (((table[i + 1] - table[i]) * frac) >> frac_bits));
+    }
+
+    // Linear interpolation is only good to ~18 bits with this table size.
+    // Q31 rotates the entry a by the remainder d instead:
+    // cos(a + d) = cos(a) (1 - d^2 / 2 + d^4 / 24) - sin(a) (d - d^3 / 6),
+    // with sin(a) the mirrored entry and d < pi / 2^9, so the dropped terms
+    // are below 2^-40
+    template <>
+    inline Q31 QuarterCos<Q31>(std::uint32_t t)
+    {
+        int const SHIFT = 30 - FIXED_COS_TABLE_BITS;
+        std::int64_t const PI_2_Q36 = 107944301636LL; // pi / 2 in Q36
+
+        Q31 const * table = QuarterCosTable<Q31>::array;
+        std::uint32_t i = t >> SHIFT;
+        std::int64_t rem = t & ((1u << SHIFT) - 1);
+        std::int64_t d = (rem * PI_2_Q36 + (1 << 29)) >> 30;          // Q36
+        std::int64_t d2 = (d * d) >> 36;                              // Q36
+        std::int64_t cd = (d2 >> 1) - (((d2 * d2) >> 36) + 12) / 24;  // Q36
+        std::int64_t sd = d - (((d2 * d) >> 36) + 3) / 6;             // Q36
+        // 1 is stored saturated to 1 - 2^-31: add the missing step back
+        std::int64_t cos_a = static_cast<std::int64_t>(table[i]) + (i == 0);
+        std::int64_t sin_a = table[QuarterCosTable<Q31>::SIZE - 1 - i];
+        std::int64_t delta = cos_a * cd + sin_a * sd;                 // Q67
+        return Saturate<Q31>(cos_a - ((delta + (std::int64_t(1) << 35)) >> 36));
+    }
+
+    template <typename Q>
+    inline Q Cos(std::uint32_t phase)
+    {
+        std::uint32_t const QUARTER = 1u << 30;
+        std::uint32_t t = phase & (QUARTER - 1);
+        switch(phase >> 30)
+        {
+            case 0:  return QuarterCos<Q>(t);
+            case 1:  return static_cast<Q>(-QuarterCos<Q>(QUARTER - t));
+            case 2:  return static_cast<Q>(-QuarterCos<Q>(t));
+            default: return QuarterCos<Q>(QUARTER - t);
+        }
+    }
+
+    template <typename Q>
+    inline Q Sin(std::uint32_t phase)
+    {
+        return Cos<Q>(phase - (1u << 30));
+    }
+
+}
+
+//==============================================================================
+// Fixed-point CORDIC cosinus, STEPS iterations
+//==============================================================================
+namespace Cordic {
+
+    using namespace FixedPoint;
+
+    static int const MAX_STEPS = 40;
+
+    // atan(2^-i) in phase units with 32 guard bits (2^64 per turn)
+    static std::int64_t const ATAN[MAX_STEPS] = {
+        2305843009213693952LL, 1361218612134873190LL, 719230530580881038LL,
+        365092647525521947LL, 183254791493294829LL, 91716730292036216LL,
+        45869556482713130LL, 22936177926750895LL, 11468263948075831LL,
+        5734153847876408LL, 2867079658191483LL, 1433540170878135LL,
+        716770128161890LL, 358385069421298LL, 179192535378193LL,
+        89596267772540LL, 44798133896700LL, 22399066949654LL, 11199533474990LL,
+        5599766737515LL, 2799883368760LL, 1399941684380LL, 699970842190LL,
+        349985421095LL, 174992710548LL, 87496355274LL, 43748177637LL,
+        21874088818LL, 10937044409LL, 5468522205LL, 2734261102LL, 1367130551LL,
+        683565276LL, 341782638LL, 170891319LL, 85445659LL, 42722830LL,
+        21361415LL, 10680707LL, 5340354LL
+    };
+
+    // Product of the 1 / sqrt(1 + 2^-2i) for i < N, in Q62 (index N - 1)
+    static std::int64_t const GAIN[MAX_STEPS] = {
+        3260954456333195553LL, 2916686334356757942LL, 2829601372552588592LL,
+        2807750841902562267LL, 2802282967498353433LL, 2800915666627739259LL,
+        2800573820569637254LL, 2800488357751430639LL, 2800466991965380887LL,
+        2800461650513774536LL, 2800460315150554575LL, 2800459981309729686LL,
+        2800459897849522220LL, 2800459876984470276LL, 2800459871768207285LL,
+        2800459870464141537LL, 2800459870138125100LL, 2800459870056620990LL,
+        2800459870036244963LL, 2800459870031150956LL, 2800459870029877455LL,
+        2800459870029559079LL, 2800459870029479485LL, 2800459870029459587LL,
+        2800459870029454612LL, 2800459870029453369LL, 2800459870029453058LL,
+        2800459870029452980LL, 2800459870029452960LL, 2800459870029452956LL,
+        2800459870029452954LL, 2800459870029452954LL, 2800459870029452954LL,
+        2800459870029452954LL, 2800459870029452954LL, 2800459870029452954LL,
+        2800459870029452954LL, 2800459870029452954LL, 2800459870029452954LL,
+        2800459870029452954LL
+    };
+
+    // v / 2^drop, rounded
+    inline std::int64_t Drop(std::int64_t v, int drop)
+    {
+        return drop ? (v + (std::int64_t(1) << (drop - 1))) >> drop : v;
+    }
+
+    // The accumulator (Q30 in int32, Q62 in int64) to Q
+    template <typename Q>
+    inline Q FromCordic(std::int32_t v) { return FromQ30<Q>(v); }
+
+    template <typename Q>
+    inline Q FromCordic(std::int64_t v) { return FromQ62<Q>(v); }
+
+    // In int64, x and y in Q62 and the 32 guard bits of z keep the rounding
+    // of the shifts and of the angles below the Q31 output up to 40 steps.
+    // In int32 the tables are rounded to Q30 and to 2^32 per turn.
+    template <typename Q, int STEPS>
+    inline void SinCos(std::uint32_t phase, Q & s, Q & c)
+    {
+        typedef typename Format<Q>::Cordic I;
+        int const BITS = sizeof(I) * 8;
+        int const DROP = 64 - BITS;
+        static_assert(STEPS >= 1 && STEPS <= (BITS == 32 ? 30 : MAX_STEPS),
+                      "1 to 30 CORDIC steps in int32, 40 in int64");
+
+        // Rotate by pi the angles outside [-pi/2, pi/2)
+        bool flip = ((phase + (1u << 30)) >> 31) != 0;
+        I z = static_cast<I>(static_cast<std::int32_t>(flip ? phase - (1u << 31) : phase)) *
+              (I(1) << (BITS - 32));
+        I x = static_cast<I>(Drop(GAIN[STEPS - 1], DROP));
+        I y = 0;
+
+        // Constant trip count: unrolled by the compiler
+        for(int i = 0; i < STEPS; ++i)
+        {
+            // Branchless: m is 0 to rotate forward, -1 to rotate backward,
+            // and (v ^ m) - m is v or -v
+            I m = z >> (BITS - 1);
+            I dx = y >> i;
+            I dy = x >> i;
+            x -= (dx ^ m) - m;
+            y += (dy ^ m) - m;
+            z -= (static_cast<I>(Drop(ATAN[i], DROP)) ^ m) - m;
+        }
+
+        c = FromCordic<Q>(flip ? -x : x);
+        s = FromCordic<Q>(flip ? -y : y);
+    }
+
+    template <typename Q, int STEPS>
+    inline Q Cos(std::uint32_t phase)
+    {
+        Q s, c;
+        SinCos<Q, STEPS>(phase, s, c);
+        return c;
+    }
+
+    template <typename Q, int STEPS>
+    inline Q Sin(std::uint32_t phase)
+    {
+        Q s, c;
+        SinCos<Q, STEPS>(phase, s, c);
+        return s;
+    }
 
 }
 
@@ -144,7 +571,9 @@ namespace Cos {
         std::cout << Inline::Cos(45 * TO_RAD, 100) << std::endl;
         std::cout << RecursiveTemplateFunc::Cos<100>(45 * TO_RAD) << std::endl;
         std::cout << RecursiveTemplateStruct::Cos<45, 100>::Value << std::endl;
+        std::cout << ShallowTemplateStruct::Cos<45, 100>::Value << std::endl;
         std::cout << CompileTimeArray::cosinus[45] << std::endl;
+        std::cout << ShallowCompileTimeArray::cosinus[45] << std::endl;
         std::cout << Constexpr::Cos(45 * TO_RAD, 50) << std::endl;
         std::cout << std::cos(45 * TO_RAD) << std::endl;
         std::cout << std::endl;
@@ -185,6 +614,15 @@ namespace Cos {
         dur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
         std::cout << "Recursive template struct : " << dur.count() << "ms" << std::endl;
 
+        start = std::chrono::high_resolution_clock::now();
+        for(int i = 0; i < n; ++i)
+        {
+            auto f = ShallowTemplateStruct::Cos<45, 100>::Value;
+        }
+        end = std::chrono::high_resolution_clock::now();
+        dur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        std::cout << "Shallow template struct : " << dur.count() << "ms" << std::endl;
+
         start = std::chrono::high_resolution_clock::now();
         for(int i = 0; i < n; ++i)
         {
@@ -194,6 +632,15 @@ namespace Cos {
         dur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
         std::cout << "Compile-time array : " << dur.count() << "ms" << std::endl;
 
+        start = std::chrono::high_resolution_clock::now();
+        for(int i = 0; i < n; ++i)
+        {
+            auto c = ShallowCompileTimeArray::cosinus[45];
+        }
+        end = std::chrono::high_resolution_clock::now();
+        dur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        std::cout << "Shallow compile-time array : " << dur.count() << "ms" << std::endl;
+
         start = std::chrono::high_resolution_clock::now();
         for(int i = 0; i < n; ++i)
         {
@@ -206,6 +653,96 @@ namespace Cos {
         std::cout << "Constexpr : " << dur.count() << "ms" << std::endl;
     }
 
+    // ns per call of f over n phases spread over the whole turn
+    template <typename F>
+    double time_phases(F f, int n, double & sink)
+    {
+        typedef decltype(f(0u)) R;
+        typename std::conditional<std::is_integral<R>::value, long long, double>::type sum = 0;
+
+        std::uint32_t phase = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for(int i = 0; i < n; ++i)
+        {
+            sum += f(phase);
+            phase += 2654435769u; // 2^32 / golden ratio
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        sink += static_cast<double>(sum);
+        return std::chrono::duration<double, std::nano>(end - start).count() / n;
+    }
+
+    // Max absolute error of to_double(f(phase)) against std::cos
+    template <typename F, typename D>
+    double max_error(F f, D to_double)
+    {
+        double err = 0.0;
+        for(std::uint32_t i = 0; i < (1u << 20); ++i)
+        {
+            std::uint32_t phase = i * 4096u + 1234u;
+            double x = static_cast<std::int32_t>(phase) * (2.0 * M_PI / 4294967296.0);
+            err = std::max(err, std::abs(to_double(f(phase)) - std::cos(x)));
+        }
+        return err;
+    }
+
+    template <typename F, typename D>
+    void print_fixed_point(char const * name, F f, D to_double, int n, double & sink)
+    {
+        double err = max_error(f, to_double);
+        std::cout << std::setw(28) << std::left << name << std::right
+                  << std::setw(8) << time_phases(f, n, sink) << "ns"
+                  << std::setw(14) << err
+                  << std::setw(8) << (err > 0 ? -std::log2(err) : 64.0) << " bits"
+                  << std::endl;
+    }
+
+    void fixed_point_benchmark(int n)
+    {
+        using namespace FixedPoint;
+
+        // Radians in [-pi, pi) from the phase, for the double variants
+        auto rad = [](std::uint32_t p)
+        {
+            return static_cast<std::int32_t>(p) * (2.0 * M_PI / 4294967296.0);
+        };
+        auto same = [](double d) { return d; };
+        auto q15 = [](Q15 q) { return ToDouble(q); };
+        auto q31 = [](Q31 q) { return ToDouble(q); };
+
+        double sink = 0.0;
+        std::cout << std::setw(28) << std::left << "Variant" << std::right
+                  << std::setw(10) << "per call" << std::setw(14) << "max error"
+                  << std::endl;
+
+        print_fixed_point("std::cos",
+            [&](std::uint32_t p) { return std::cos(rad(p)); }, same, n, sink);
+        print_fixed_point("Inline order 10",
+            [&](std::uint32_t p) { return Inline::Cos(rad(p), 10); }, same, n, sink);
+        print_fixed_point("Recursive template func 10",
+            [&](std::uint32_t p) { return RecursiveTemplateFunc::Cos<10>(rad(p)); }, same, n, sink);
+        print_fixed_point("Table Q15",
+            [](std::uint32_t p) { return FixedPointTable::Cos<Q15>(p); }, q15, n, sink);
+        print_fixed_point("Table Q31",
+            [](std::uint32_t p) { return FixedPointTable::Cos<Q31>(p); }, q31, n, sink);
+        print_fixed_point("CORDIC Q15 8 steps",
+            [](std::uint32_t p) { return Cordic::Cos<Q15, 8>(p); }, q15, n, sink);
+        print_fixed_point("CORDIC Q15 16 steps",
+            [](std::uint32_t p) { return Cordic::Cos<Q15, 16>(p); }, q15, n, sink);
+        print_fixed_point("CORDIC Q31 16 steps",
+            [](std::uint32_t p) { return Cordic::Cos<Q31, 16>(p); }, q31, n, sink);
+        print_fixed_point("CORDIC Q31 24 steps",
+            [](std::uint32_t p) { return Cordic::Cos<Q31, 24>(p); }, q31, n, sink);
+        print_fixed_point("CORDIC Q31 30 steps",
+            [](std::uint32_t p) { return Cordic::Cos<Q31, 30>(p); }, q31, n, sink);
+        print_fixed_point("CORDIC Q31 32 steps",
+            [](std::uint32_t p) { return Cordic::Cos<Q31, 32>(p); }, q31, n, sink);
+        print_fixed_point("CORDIC Q31 40 steps",
+            [](std::uint32_t p) { return Cordic::Cos<Q31, 40>(p); }, q31, n, sink);
+
+        std::cout << std::endl << "(" << sink << ")" << std::endl;
+    }
+
 }
 
 #endif //COS_HPP
@@ -1,17 +1,23 @@
+#include <cstring>
 #include <iostream>
 
 #include "cos.hpp"
 
 int main(int argc, char ** argv)
 {
-    if(argc > 1)
+    if(argc > 2 && !strcmp(argv[2], "fixed"))
+    {
+        std::cout << "Computing " << atoi(argv[1]) << " times fixed-point cos : \n" << std::endl;
+        Cos::fixed_point_benchmark(atoi(argv[1]));
+    }
+    else if(argc > 1)
     {
         std::cout << "Computing " << atoi(argv[1]) << " times cos(45) : \n" << std::endl;
         Cos::benchmark(atoi(argv[1]));
     }
     else
     {
-        std::cout << "./cos <loop_count>" << std::endl;
+        std::cout << "./cos <loop_count> [fixed]" << std::endl;
     }
     return 0;
 }
@@ -0,0 +1,512 @@
+#ifndef DISPATCH_HPP
+#define DISPATCH_HPP
+
+#include "../cos/cos.hpp"
+#include "../exp/exp.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+// Cos::eval(x) and Exp::eval(x) route to the fastest variant that meets the
+// required accuracy on this machine.
+//
+// On the first call (or on an explicit calibrate()), every candidate is run
+// over the domain: the ones whose max error is above the tolerance are
+// dropped and the fastest of the others is kept. The choice is cached in the
+// profile file named by TMP_DISPATCH_PROFILE, if set, and read back by the
+// next runs with the same domain and tolerance on the same machine, built by
+// the same compiler with the same flags (see identity()).
+//
+// After that, eval() is a single indirect call inside the domain. The choice
+// only holds there: outside of it eval() calls the fallback (std::cos,
+// std::exp), for one comparison.
+
+namespace Dispatch {
+
+    typedef double (*Function)(double);
+
+    struct Candidate
+    {
+        char const * name;
+        Function function;
+
+        // Filled by the calibration
+        double error;
+        double ns;
+    };
+
+    // Host, CPU model, compiler and the build flags that change the generated
+    // code, without spaces: a profile measured elsewhere does not apply
+    inline std::string const & identity()
+    {
+        static std::string const id = []() {
+            char host[256] = "unknown";
+            gethostname(host, sizeof host - 1);
+
+            std::string cpu = "unknown";
+            std::ifstream cpuinfo("/proc/cpuinfo");
+            std::string line;
+            while(std::getline(cpuinfo, line))
+            {
+                if(line.compare(0, 10, "model name") == 0)
+                {
+                    cpu = line.substr(line.find(':') + 2);
+                    break;
+                }
+            }
+
+            std::ostringstream os;
+            os << host << "/" << cpu << "/"
+#if defined(__clang__)
+               << "clang-"
+#elif defined(__GNUC__)
+               << "gcc-"
+#endif
+               << __VERSION__ << "/"
+#ifdef __OPTIMIZE__
+               << "opt"
+#else
+               << "noopt"
+#endif
+#ifdef __FAST_MATH__
+               << "+fast-math"
+#endif
+#ifdef __FMA__
+               << "+fma"
+#endif
+#ifdef __AVX2__
+               << "+avx2"
+#elif defined(__AVX__)
+               << "+avx"
+#endif
+#ifdef __AVX512F__
+               << "+avx512f"
+#endif
+               ;
+            std::string id = os.str();
+            for(char & c : id) if(c == ' ' || c == '\t') c = '_';
+            return id;
+        }();
+        return id;
+    }
+
+    // Absolute error below 1, relative above
+    inline double error(double value, long double reference)
+    {
+        long double d = std::fabs(value - reference);
+        long double r = std::fabs(reference);
+        return static_cast<double>(r > 1.0L ? d / r : d);
+    }
+
+    // Tag: name(), candidates(), reference(x) and default domain/tolerance
+    template <typename Tag>
+    class Dispatcher
+    {
+    public:
+        static double eval(double x)
+        {
+            // Until the calibration starts the range is everything, so that
+            // the first call goes to first_call()
+            if(!(x >= s_eval_lo.load(std::memory_order_relaxed) &&
+                 x <= s_eval_hi.load(std::memory_order_relaxed)))
+                return Tag::fallback(x);
+            return s_function.load(std::memory_order_relaxed)(x);
+        }
+
+        // Before the first eval(), calibrate(), report() or choice(): false
+        // (and no effect) once the calibration has started
+        static bool configure(double lo, double hi, double tolerance)
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            if(s_started) return false;
+            s_lo = lo;
+            s_hi = hi;
+            s_tolerance = tolerance;
+            return true;
+        }
+
+        static void calibrate()
+        {
+            std::call_once(s_once, &Dispatcher::run);
+        }
+
+        static void report(std::ostream & os)
+        {
+            calibrate();
+
+            os << Tag::name() << " over [" << s_lo << ", " << s_hi << "], tolerance "
+               << s_tolerance << (s_from_profile ? " (from profile)" : "") << " :" << std::endl;
+            for(Candidate const & c : s_candidates)
+            {
+                os << (c.function == s_function.load() ? "  * " : "    ")
+                   << std::setw(32) << std::left << c.name << std::right;
+                if(c.error < 0.0)
+                    os << "  (not measured)";
+                else if(c.error > s_tolerance)
+                    os << std::setw(12) << c.error << "  too inaccurate";
+                else
+                    os << std::setw(12) << c.error << std::setw(10) << c.ns << "ns";
+                os << std::endl;
+            }
+        }
+
+        static char const * choice()
+        {
+            calibrate();
+            return choice_name();
+        }
+
+    private:
+        static double first_call(double x)
+        {
+            calibrate();
+            return eval(x);
+        }
+
+        static void run()
+        {
+            {
+                // The domain and tolerance are fixed from here on
+                std::lock_guard<std::mutex> lock(s_mutex);
+                s_started = true;
+                s_eval_lo.store(s_lo, std::memory_order_relaxed);
+                s_eval_hi.store(s_hi, std::memory_order_relaxed);
+            }
+
+            s_candidates = Tag::candidates();
+            for(Candidate & c : s_candidates) c.error = c.ns = -1.0;
+
+            if(!load()) { measure(); save(); }
+        }
+
+        static void measure()
+        {
+            std::size_t const SAMPLES = 1024;
+
+            std::vector<double> xs(SAMPLES);
+            for(std::size_t i = 0; i < SAMPLES; ++i)
+                xs[i] = s_lo + (s_hi - s_lo) * (i + 0.5) / SAMPLES;
+
+            Function best = &Tag::fallback;
+            double best_ns = 1e300;
+
+            for(Candidate & c : s_candidates)
+            {
+                c.error = 0.0;
+                for(double x : xs)
+                    c.error = std::max(c.error, error(c.function(x), Tag::reference(x)));
+                if(!(c.error <= s_tolerance)) continue;
+
+                // Best of 5, called through the pointer as eval() does
+                Function volatile f = c.function;
+                c.ns = 1e300;
+                for(int run = 0; run < 5; ++run)
+                {
+                    double sum = 0.0;
+                    auto start = std::chrono::high_resolution_clock::now();
+                    for(double x : xs) sum += f(x);
+                    auto end = std::chrono::high_resolution_clock::now();
+                    s_sink += sum;
+                    c.ns = std::min(c.ns, std::chrono::duration<double, std::nano>(end - start).count() / SAMPLES);
+                }
+
+                if(c.ns < best_ns)
+                {
+                    best = c.function;
+                    best_ns = c.ns;
+                }
+            }
+
+            s_function.store(best);
+        }
+
+        static char const * profile()
+        {
+            return std::getenv("TMP_DISPATCH_PROFILE");
+        }
+
+        // Profile lines: <identity> <function> <lo> <hi> <tolerance> <candidate>
+        static bool load()
+        {
+            if(!profile()) return false;
+            std::ifstream in(profile());
+            std::string line;
+            while(std::getline(in, line))
+            {
+                std::istringstream is(line);
+                std::string id, name, candidate;
+                double lo, hi, tolerance;
+                if(!(is >> id >> name >> lo >> hi >> tolerance) || id != identity() ||
+                   name != Tag::name() || lo != s_lo || hi != s_hi || tolerance != s_tolerance)
+                    continue;
+                std::getline(is >> std::ws, candidate);
+                for(Candidate const & c : s_candidates)
+                {
+                    if(candidate == c.name)
+                    {
+                        s_function.store(c.function);
+                        s_from_profile = true;
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        static void save()
+        {
+            if(!profile()) return;
+            std::ofstream out(profile(), std::ios::app);
+            out << std::setprecision(17) << identity() << " " << Tag::name() << " " << s_lo << " " << s_hi
+                << " " << s_tolerance << " " << choice_name() << std::endl;
+        }
+
+        static char const * choice_name()
+        {
+            for(Candidate const & c : s_candidates)
+                if(c.function == s_function.load()) return c.name;
+            return "";
+        }
+
+        static std::atomic<Function> s_function;
+        static std::atomic<double> s_eval_lo; // Domain of s_function
+        static std::atomic<double> s_eval_hi;
+        static std::once_flag s_once;
+        static std::mutex s_mutex;
+        static bool s_started;
+        static std::vector<Candidate> s_candidates;
+        static double s_lo;
+        static double s_hi;
+        static double s_tolerance;
+        static bool s_from_profile;
+        static double s_sink;
+    };
+
+    template <typename Tag>
+    std::atomic<Function> Dispatcher<Tag>::s_function(&Dispatcher<Tag>::first_call);
+
+    template <typename Tag>
+    std::atomic<double> Dispatcher<Tag>::s_eval_lo(-std::numeric_limits<double>::infinity());
+
+    template <typename Tag>
+    std::atomic<double> Dispatcher<Tag>::s_eval_hi(std::numeric_limits<double>::infinity());
+
+    template <typename Tag>
+    std::once_flag Dispatcher<Tag>::s_once;
+
+    template <typename Tag>
+    std::mutex Dispatcher<Tag>::s_mutex;
+
+    template <typename Tag>
+    bool Dispatcher<Tag>::s_started = false;
+
+    template <typename Tag>
+    std::vector<Candidate> Dispatcher<Tag>::s_candidates;
+
+    template <typename Tag>
+    double Dispatcher<Tag>::s_lo = Tag::LO;
+
+    template <typename Tag>
+    double Dispatcher<Tag>::s_hi = Tag::HI;
+
+    template <typename Tag>
+    double Dispatcher<Tag>::s_tolerance = Tag::TOLERANCE;
+
+    template <typename Tag>
+    bool Dispatcher<Tag>::s_from_profile = false;
+
+    template <typename Tag>
+    double Dispatcher<Tag>::s_sink = 0.0;
+
+//==============================================================================
+// Cosinus candidates
+//==============================================================================
+
+    template <int N> double NormalCos(double x) { return Normal::Cos(x, N); }
+    template <int N> double InlineCos(double x) { return Inline::Cos(x, N); }
+    template <int N> double TemplateFuncCos(double x) { return RecursiveTemplateFunc::Cos<N>(x); }
+    template <int N> double ConstexprCos(double x) { return Constexpr::Cos(x, N); }
+
+    inline double TableCos(double x)
+    {
+        return FixedPoint::ToDouble(FixedPointTable::Cos<FixedPoint::Q31>(FixedPoint::Phase(x)));
+    }
+
+    template <int STEPS>
+    double CordicCos(double x)
+    {
+        return FixedPoint::ToDouble(Cordic::Cos<FixedPoint::Q31, STEPS>(FixedPoint::Phase(x)));
+    }
+
+    struct CosTag
+    {
+        static constexpr double LO = 0.0;
+        static constexpr double HI = M_PI / 2.0;
+        static constexpr double TOLERANCE = 1e-12;
+
+        static char const * name() { return "cos"; }
+
+        static long double reference(double x) { return std::cos(static_cast<long double>(x)); }
+
+        static double fallback(double x) { return std::cos(x); }
+
+        static std::vector<Candidate> candidates()
+        {
+            return {
+                { "std::cos", &fallback, 0, 0 },
+                { "Normal::Cos(x, 8)", &NormalCos<8>, 0, 0 },
+                { "Normal::Cos(x, 12)", &NormalCos<12>, 0, 0 },
+                { "Normal::Cos(x, 16)", &NormalCos<16>, 0, 0 },
+                { "Inline::Cos(x, 8)", &InlineCos<8>, 0, 0 },
+                { "Inline::Cos(x, 12)", &InlineCos<12>, 0, 0 },
+                { "Inline::Cos(x, 16)", &InlineCos<16>, 0, 0 },
+                { "RecursiveTemplateFunc::Cos<8>", &TemplateFuncCos<8>, 0, 0 },
+                { "RecursiveTemplateFunc::Cos<12>", &TemplateFuncCos<12>, 0, 0 },
+                { "RecursiveTemplateFunc::Cos<16>", &TemplateFuncCos<16>, 0, 0 },
+                { "Constexpr::Cos(x, 8)", &ConstexprCos<8>, 0, 0 },
+                { "Constexpr::Cos(x, 12)", &ConstexprCos<12>, 0, 0 },
+                { "Constexpr::Cos(x, 16)", &ConstexprCos<16>, 0, 0 },
+                { "FixedPointTable::Cos<Q31>", &TableCos, 0, 0 },
+                { "Cordic::Cos<Q31, 16>", &CordicCos<16>, 0, 0 },
+                { "Cordic::Cos<Q31, 30>", &CordicCos<30>, 0, 0 },
+            };
+        }
+    };
+
+//==============================================================================
+// Exponential candidates
+//==============================================================================
+
+    template <int N> double NormalExp(double x) { return Normal::Exp(x, N); }
+    template <int N> double InlineExp(double x) { return Inline::Exp(x, N); }
+    template <int N> double TemplateFuncExp(double x) { return RecursiveTemplateFunc::Exp<N>(x); }
+    template <int N> double ConstexprExp(double x) { return Constexpr::Exp(x, N); }
+
+    struct ExpTag
+    {
+        static constexpr double LO = -1.0;
+        static constexpr double HI = 1.0;
+        static constexpr double TOLERANCE = 1e-12;
+
+        static char const * name() { return "exp"; }
+
+        static long double reference(double x) { return std::exp(static_cast<long double>(x)); }
+
+        static double fallback(double x) { return std::exp(x); }
+
+        static std::vector<Candidate> candidates()
+        {
+            return {
+                { "std::exp", &fallback, 0, 0 },
+                { "Normal::Exp(x, 10)", &NormalExp<10>, 0, 0 },
+                { "Normal::Exp(x, 15)", &NormalExp<15>, 0, 0 },
+                { "Normal::Exp(x, 20)", &NormalExp<20>, 0, 0 },
+                { "Inline::Exp(x, 10)", &InlineExp<10>, 0, 0 },
+                { "Inline::Exp(x, 15)", &InlineExp<15>, 0, 0 },
+                { "Inline::Exp(x, 20)", &InlineExp<20>, 0, 0 },
+                { "RecursiveTemplateFunc::Exp<10>", &TemplateFuncExp<10>, 0, 0 },
+                { "RecursiveTemplateFunc::Exp<15>", &TemplateFuncExp<15>, 0, 0 },
+                { "RecursiveTemplateFunc::Exp<20>", &TemplateFuncExp<20>, 0, 0 },
+                { "Constexpr::Exp(x, 10)", &ConstexprExp<10>, 0, 0 },
+                { "Constexpr::Exp(x, 15)", &ConstexprExp<15>, 0, 0 },
+                { "Constexpr::Exp(x, 20)", &ConstexprExp<20>, 0, 0 },
+            };
+        }
+    };
+
+    constexpr double CosTag::LO;
+    constexpr double CosTag::HI;
+    constexpr double CosTag::TOLERANCE;
+    constexpr double ExpTag::LO;
+    constexpr double ExpTag::HI;
+    constexpr double ExpTag::TOLERANCE;
+
+}
+
+//==============================================================================
+// Facades
+//==============================================================================
+namespace Cos {
+
+    typedef Dispatch::Dispatcher<Dispatch::CosTag> Dispatcher;
+
+    inline double eval(double x)
+    {
+        return Dispatcher::eval(x);
+    }
+
+}
+
+namespace Exp {
+
+    typedef Dispatch::Dispatcher<Dispatch::ExpTag> Dispatcher;
+
+    inline double eval(double x)
+    {
+        return Dispatcher::eval(x);
+    }
+
+}
+
+//==============================================================================
+// Minimalist benchmark
+//==============================================================================
+namespace Dispatch {
+
+    template <typename F>
+    double time_calls(F f, double lo, double hi, int n, double & sink)
+    {
+        double sum = 0.0;
+        double step = (hi - lo) / n;
+        auto start = std::chrono::high_resolution_clock::now();
+        for(int i = 0; i < n; ++i)
+        {
+            sum += f(lo + i * step);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        sink += sum;
+        return std::chrono::duration<double, std::nano>(end - start).count() / n;
+    }
+
+    void benchmark(int n)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        Cos::Dispatcher::calibrate();
+        Exp::Dispatcher::calibrate();
+        auto end = std::chrono::high_resolution_clock::now();
+        auto dur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        std::cout << "Calibration : " << dur.count() << "ms" << std::endl << std::endl;
+
+        Cos::Dispatcher::report(std::cout);
+        std::cout << std::endl;
+        Exp::Dispatcher::report(std::cout);
+        std::cout << std::endl;
+
+        double sink = 0.0;
+        std::cout << "Cos::eval : " << time_calls(Cos::eval, 0.0, M_PI / 2.0, n, sink) << "ns" << std::endl;
+        std::cout << "std::cos : " << time_calls([](double x) { return std::cos(x); },
+                                                 0.0, M_PI / 2.0, n, sink) << "ns" << std::endl;
+        std::cout << "Exp::eval : " << time_calls(Exp::eval, -1.0, 1.0, n, sink) << "ns" << std::endl;
+        std::cout << "std::exp : " << time_calls([](double x) { return std::exp(x); },
+                                                 -1.0, 1.0, n, sink) << "ns" << std::endl;
+        std::cout << std::endl << "Outside of the domain, the fallback:" << std::endl;
+        std::cout << "Cos::eval(10) : " << Cos::eval(10.0) << ", std::cos(10) : " << std::cos(10.0) << std::endl;
+        std::cout << "Exp::eval(10) : " << Exp::eval(10.0) << ", std::exp(10) : " << std::exp(10.0) << std::endl;
+        std::cout << std::endl << "(" << sink << ")" << std::endl;
+    }
+
+}
+
+#endif //DISPATCH_HPP
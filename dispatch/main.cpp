@@ -0,0 +1,52 @@
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include "dispatch.hpp"
+
+static void usage()
+{
+    std::cout << "./dispatch <loop_count> [tolerance]" << std::endl;
+}
+
+int main(int argc, char ** argv)
+{
+    if(argc < 2 || argc > 3)
+    {
+        usage();
+        return argc < 2 ? 0 : 1;
+    }
+
+    char * end;
+    errno = 0;
+    long n = std::strtol(argv[1], &end, 10);
+    if(end == argv[1] || *end || errno || n <= 0 || n > std::numeric_limits<int>::max())
+    {
+        std::cerr << "<loop_count> must be a positive integer" << std::endl;
+        usage();
+        return 1;
+    }
+
+    if(argc > 2)
+    {
+        errno = 0;
+        double tolerance = std::strtod(argv[2], &end);
+        if(end == argv[2] || *end || errno || !std::isfinite(tolerance) || tolerance <= 0.0)
+        {
+            std::cerr << "[tolerance] must be a positive number" << std::endl;
+            usage();
+            return 1;
+        }
+        if(!Cos::Dispatcher::configure(0.0, M_PI / 2.0, tolerance) ||
+           !Exp::Dispatcher::configure(-1.0, 1.0, tolerance))
+        {
+            std::cerr << "configure() after the calibration: ignored" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Computing " << n << " times Cos::eval and Exp::eval : \n" << std::endl;
+    Dispatch::benchmark(static_cast<int>(n));
+    return 0;
+}
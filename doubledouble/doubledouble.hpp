@@ -0,0 +1,456 @@
+#ifndef DOUBLEDOUBLE_HPP
+#define DOUBLEDOUBLE_HPP
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "../cos/cos.hpp"
+#include "../exp/exp.hpp"
+
+// Double-double: a number held as the unevaluated sum hi + lo of two doubles,
+// |lo| <= ulp(hi) / 2, hence about 106 bits of mantissa with the exponent
+// range of a double. The arithmetic only needs double operations: the
+// rounding error of a sum or a product is itself a double, computed exactly
+// by an error-free transform (TwoSum, and TwoProd with one fma).
+//
+// With a hardware fma (-mfma), a product costs a few double operations,
+// against the x87 unit for long double (64 bits only). A sum costs about
+// twenty, hence the series are several times slower than the long double
+// libm functions. The arithmetic relies on strict IEEE double evaluation:
+// no -ffast-math, no -ffp-contract=fast (the default of -std=gnu++, the
+// Makefile uses -std=c++11).
+//
+// The functions reduce their argument first, so that the series converges
+// to the full precision with a small order n:
+//
+//     Exp(x, n)       : x = k ln2 + r, expm1(r / 2^9) to order n, squared
+//                       back 9 times (n = 10 for 106 bits)
+//     Cos(x, n)       : x = k pi/2 + r, cos or sin of r to order 2n
+//                       (n = 14 for 106 bits, minus about log2 |x| bits
+//                       lost in the reduction)
+//     Pow(x, n)       : square-and-multiply, n integer
+//     Factorial(n)    : product, exact as long as it fits 106 bits (n <= 30)
+
+namespace DoubleDouble {
+
+//==============================================================================
+// Arithmetic
+//==============================================================================
+
+    struct Number
+    {
+        double hi;
+        double lo;
+
+        Number(double hi = 0.0, double lo = 0.0) : hi(hi), lo(lo) { }
+    };
+
+    // a + b = s + e exactly, no condition on a and b (Knuth)
+    inline Number TwoSum(double a, double b)
+    {
+        double s = a + b;
+        double bb = s - a;
+        return Number(s, (a - (s - bb)) + (b - bb));
+    }
+
+    // a + b = s + e exactly, |a| >= |b| (Dekker)
+    inline Number QuickTwoSum(double a, double b)
+    {
+        double s = a + b;
+        return Number(s, b - (s - a));
+    }
+
+    // a * b = p + e exactly, no overflow nor underflow: the fma rounds once
+    inline Number TwoProd(double a, double b)
+    {
+        double p = a * b;
+        return Number(p, std::fma(a, b, -p));
+    }
+
+    inline Number operator-(Number a)
+    {
+        return Number(-a.hi, -a.lo);
+    }
+
+    inline Number operator+(Number a, Number b)
+    {
+        Number s = TwoSum(a.hi, b.hi);
+        Number t = TwoSum(a.lo, b.lo);
+        s = QuickTwoSum(s.hi, s.lo + t.hi);
+        return QuickTwoSum(s.hi, s.lo + t.lo);
+    }
+
+    inline Number operator+(Number a, double b)
+    {
+        Number s = TwoSum(a.hi, b);
+        return QuickTwoSum(s.hi, s.lo + a.lo);
+    }
+
+    inline Number operator-(Number a, Number b)
+    {
+        return a + -b;
+    }
+
+    // On overflow the error term of TwoProd is fma(a, b, -inf), NaN: the
+    // products return {+-inf, 0} instead
+    inline Number operator*(Number a, Number b)
+    {
+        Number p = TwoProd(a.hi, b.hi);
+        if(std::isinf(p.hi)) return Number(p.hi, 0.0);
+        return QuickTwoSum(p.hi, std::fma(a.hi, b.lo, std::fma(a.lo, b.hi, p.lo)));
+    }
+
+    inline Number operator*(Number a, double b)
+    {
+        Number p = TwoProd(a.hi, b);
+        if(std::isinf(p.hi)) return Number(p.hi, 0.0);
+        return QuickTwoSum(p.hi, std::fma(a.lo, b, p.lo));
+    }
+
+    // Long division: three quotient digits, the remainders computed exactly
+    inline Number operator/(Number a, Number b)
+    {
+        double q1 = a.hi / b.hi;
+        Number r = a - b * q1;
+        double q2 = r.hi / b.hi;
+        r = r - b * q2;
+        double q3 = r.hi / b.hi;
+        return QuickTwoSum(q1, q2) + q3;
+    }
+
+    // b exact: two quotient digits are enough
+    inline Number operator/(Number a, double b)
+    {
+        double q1 = a.hi / b;
+        Number p = TwoProd(q1, b);
+        double q2 = ((a.hi - p.hi) - p.lo + a.lo) / b;
+        return QuickTwoSum(q1, q2);
+    }
+
+    // a * 2^e, exact
+    inline Number Ldexp(Number a, int e)
+    {
+        return Number(std::ldexp(a.hi, e), std::ldexp(a.lo, e));
+    }
+
+    inline long double ToLongDouble(Number a)
+    {
+        return static_cast<long double>(a.hi) + a.lo;
+    }
+
+//==============================================================================
+// Functions
+//==============================================================================
+
+    static Number const LN2(6.931471805599452862e-01, 2.319046813846299558e-17);
+    static Number const PI_2(1.570796326794896558e+00, 6.123233995736766036e-17);
+
+    static int const EXP_HALVINGS = 9;
+
+    // 1 / k! for k < INVERSE_FACTORIALS: the coefficients of the series,
+    // computed once
+    static int const INVERSE_FACTORIALS = 171;
+
+    inline Number const * InverseFactorials()
+    {
+        static struct Table
+        {
+            Number inverses[INVERSE_FACTORIALS];
+
+            Table()
+            {
+                inverses[0] = 1.0;
+                for(int k = 1; k < INVERSE_FACTORIALS; ++k) inverses[k] = inverses[k - 1] / static_cast<double>(k);
+            }
+        } const table;
+        return table.inverses;
+    }
+
+    // inf on overflow, 0 for the reciprocal of an overflow (n < 0)
+    inline Number Pow(Number x, int n)
+    {
+        Number r = 1.0;
+        for(unsigned e = n < 0 ? 0u - static_cast<unsigned>(n) : static_cast<unsigned>(n); e; e >>= 1)
+        {
+            if(e & 1u) r = r * x;
+            x = x * x;
+        }
+        if(n >= 0) return r;
+        return std::isinf(r.hi) ? Number(std::copysign(0.0, r.hi)) : Number(1.0) / r;
+    }
+
+    // inf from n = 171 on
+    inline Number Factorial(int n)
+    {
+        Number r = 1.0;
+        for(int i = 2; i <= n; ++i) r = r * static_cast<double>(i);
+        return r;
+    }
+
+    // expm1(r) to order n < INVERSE_FACTORIALS, Horner
+    inline Number Expm1_(Number r, int n)
+    {
+        Number const * c = InverseFactorials();
+        Number p = c[n];
+        for(int i = n - 1; i >= 1; --i) p = p * r + c[i];
+        return p * r;
+    }
+
+    inline Number Exp(Number x, int n)
+    {
+        if(x.hi > 709.8) return std::numeric_limits<double>::infinity();
+        if(x.hi < -745.2) return 0.0;
+
+        double k = std::floor(x.hi / LN2.hi + 0.5);
+        Number s = Expm1_(Ldexp(x - LN2 * k, -EXP_HALVINGS), n);
+
+        // expm1(2r) = 2 expm1(r) + expm1(r)^2: no cancellation, unlike squaring
+        // exp(r) which loses the low bits of 1 + small (2 s is exact)
+        for(int i = 0; i < EXP_HALVINGS; ++i) s = Number(2.0 * s.hi, 2.0 * s.lo) + s * s;
+        return Ldexp(s + 1.0, static_cast<int>(k));
+    }
+
+    // cos(r) to order 2n, 2n + 1 < INVERSE_FACTORIALS, Horner in r^2
+    inline Number Cos_(Number r, int n)
+    {
+        Number const * c = InverseFactorials();
+        Number r2 = r * r;
+        Number p = c[2 * n];
+        for(int i = n - 1; i >= 0; --i) p = -(p * r2) + c[2 * i];
+        return p;
+    }
+
+    // sin(r) to order 2n + 1, Horner in r^2
+    inline Number Sin_(Number r, int n)
+    {
+        Number const * c = InverseFactorials();
+        Number r2 = r * r;
+        Number p = c[2 * n + 1];
+        for(int i = n - 1; i >= 0; --i) p = -(p * r2) + c[2 * i + 1];
+        return p * r;
+    }
+
+    inline Number Cos(Number x, int n)
+    {
+        double k = std::floor(x.hi / PI_2.hi + 0.5);
+        Number r = x - PI_2 * k;
+        switch(static_cast<long long>(k) & 3)
+        {
+            case 0: return Cos_(r, n);
+            case 1: return -Sin_(r, n);
+            case 2: return -Cos_(r, n);
+            default: return Sin_(r, n);
+        }
+    }
+
+    inline Number Sin(Number x, int n)
+    {
+        return Cos(x - PI_2, n);
+    }
+
+    // First digits of a, in scientific notation
+    inline std::string ToString(Number a, int digits = 32)
+    {
+        if(a.hi == 0.0 || !std::isfinite(a.hi)) return std::to_string(a.hi);
+
+        std::string s = a.hi < 0.0 ? "-" : "";
+        if(a.hi < 0.0) a = -a;
+        int e = static_cast<int>(std::floor(std::log10(a.hi)));
+        a = e > 0 ? a / Pow(10.0, e) : a * Pow(10.0, -e);
+        for(; a.hi >= 10.0; ++e) a = a / 10.0;
+        for(; a.hi < 1.0; --e) a = a * 10.0;
+
+        for(int i = 0; i < digits; ++i)
+        {
+            // The low part can make hi one ulp too high or too low
+            int d = static_cast<int>(std::floor(a.hi));
+            if(d > 9) d = 9;
+            a = a + -static_cast<double>(d);
+            if(a.hi < 0.0) { --d; a = a + 1.0; }
+            s += static_cast<char>('0' + d);
+            if(i == 0) s += '.';
+            a = a * 10.0;
+        }
+        return s + "e" + std::to_string(e);
+    }
+
+}
+
+//==============================================================================
+// Minimalist benchmark
+//==============================================================================
+namespace DoubleDouble {
+
+    // Inputs of the benchmark, cycled through
+    static int const SIZE = 1024;
+
+    // ns per call of f over the inputs, n calls
+    template <typename F>
+    double time_calls(F f, std::vector<double> const & xs, int n, double & sink)
+    {
+        double sum = 0.0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for(int i = 0; i < n; ++i)
+        {
+            sum += static_cast<double>(f(xs[i & (SIZE - 1)]));
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        sink += sum;
+        return std::chrono::duration<double, std::nano>(end - start).count() / n;
+    }
+
+    inline double bits(long double error)
+    {
+        return error == 0.0L ? 106.0 : std::min(106.0, -std::log2(static_cast<double>(error)));
+    }
+
+    // Bits of agreement of f with the double-double reference, min over the
+    // inputs
+    template <typename F, typename R>
+    double agreement(F f, R reference, std::vector<double> const & xs)
+    {
+        long double error = 0.0L;
+        for(double x : xs)
+        {
+            Number r = reference(x);
+            long double e = std::fabs(static_cast<long double>(f(x)) - r.hi - r.lo) / std::fabs(r.hi);
+            error = std::max(error, e);
+        }
+        return bits(error);
+    }
+
+    // Bits of the residual |identity(x) - 1| of the double-double functions,
+    // min over the inputs
+    template <typename I>
+    double residual(I identity, std::vector<double> const & xs)
+    {
+        long double error = 0.0L;
+        for(double x : xs)
+        {
+            Number r = identity(x) + -1.0;
+            error = std::max(error, std::fabs(static_cast<long double>(r.hi) + r.lo));
+        }
+        return bits(error);
+    }
+
+    inline void row(char const * name, double ns, double bits)
+    {
+        std::cout << std::setw(30) << std::left << name << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(10) << ns
+                  << std::setprecision(1) << std::setw(10) << bits << std::endl;
+    }
+
+    inline void header(char const * title)
+    {
+        std::cout << std::setw(30) << std::left << title << std::right
+                  << std::setw(10) << "ns" << std::setw(10) << "bits" << std::endl;
+    }
+
+    inline std::vector<double> inputs(double lo, double hi)
+    {
+        std::vector<double> xs(SIZE);
+        for(int i = 0; i < SIZE; ++i) xs[i] = lo + (hi - lo) * (i + 0.5) / SIZE;
+        return xs;
+    }
+
+    void benchmark(int n)
+    {
+        std::cout << "e         = " << ToString(Exp(1.0, 10)) << std::endl;
+        std::cout << "            2.7182818284590452353602874713526" << std::endl;
+        std::cout << "cos(1)    = " << ToString(Cos(1.0, 14)) << std::endl;
+        std::cout << "            5.4030230586813971740093660744297e-1" << std::endl;
+        std::cout << "1.5^100   = " << ToString(Pow(1.5, 100)) << std::endl;
+        std::cout << "            4.0656117753521523739727970756704e17" << std::endl;
+        std::cout << "30!       = " << ToString(Factorial(30)) << std::endl;
+        std::cout << "            2.6525285981219105863630848000000e32" << std::endl;
+        // Overflows: inf, not the NaN of TwoProd(inf, x)
+        std::cout << "171!      = " << ToString(Factorial(171)) << std::endl;
+        std::cout << "10^400    = " << ToString(Pow(10.0, 400)) << std::endl;
+        std::cout << "10^-400   = " << ToString(Pow(10.0, -400)) << std::endl;
+        std::cout << "(-10)^401 = " << ToString(Pow(-10.0, 401)) << std::endl;
+        std::cout << std::endl;
+
+        // bits: agreement with DoubleDouble for the other variants, residual
+        // of an identity for DoubleDouble
+        double sink = 0.0;
+
+        std::vector<double> xs = inputs(-10.0, 10.0);
+        auto exp_dd = [](double x) { return Exp(x, 10); };
+        header("Exp, x in [-10, 10]");
+        row("DoubleDouble::Exp(x, 10)", time_calls([&](double x) { return exp_dd(x).hi; }, xs, n, sink),
+            residual([&](double x) { return exp_dd(x) * exp_dd(-x); }, xs));
+        row("std::exp (long double)", time_calls([](double x) { return std::exp(static_cast<long double>(x)); }, xs, n, sink),
+            agreement([](double x) { return std::exp(static_cast<long double>(x)); }, exp_dd, xs));
+        row("std::exp", time_calls([](double x) { return std::exp(x); }, xs, n, sink),
+            agreement([](double x) { return std::exp(x); }, exp_dd, xs));
+        row("Inline::Exp(x, 40)", time_calls([](double x) { return Inline::Exp(x, 40); }, xs, n, sink),
+            agreement([](double x) { return Inline::Exp(x, 40); }, exp_dd, xs));
+        std::cout << std::endl;
+
+        xs = inputs(0.0, M_PI / 2.0);
+        auto cos_dd = [](double x) { return Cos(x, 14); };
+        header("Cos, x in [0, pi/2]");
+        row("DoubleDouble::Cos(x, 14)", time_calls([&](double x) { return cos_dd(x).hi; }, xs, n, sink),
+            residual([&](double x) { Number c = cos_dd(x), s = Sin(x, 14); return c * c + s * s; }, xs));
+        row("std::cos (long double)", time_calls([](double x) { return std::cos(static_cast<long double>(x)); }, xs, n, sink),
+            agreement([](double x) { return std::cos(static_cast<long double>(x)); }, cos_dd, xs));
+        row("std::cos", time_calls([](double x) { return std::cos(x); }, xs, n, sink),
+            agreement([](double x) { return std::cos(x); }, cos_dd, xs));
+        row("Inline::Cos(x, 10)", time_calls([](double x) { return Inline::Cos(x, 10); }, xs, n, sink),
+            agreement([](double x) { return Inline::Cos(x, 10); }, cos_dd, xs));
+        std::cout << std::endl;
+
+        // The residual of cos^2 + sin^2 does not see a wrong reduction (nor
+        // does exp(x) exp(-x)): the long double row compares with an
+        // independent reduction, over many periods
+        xs = inputs(-1000.0, 1000.0);
+        header("Cos, x in [-1000, 1000]");
+        row("DoubleDouble::Cos(x, 14)", time_calls([&](double x) { return cos_dd(x).hi; }, xs, n, sink),
+            residual([&](double x) { Number c = cos_dd(x), s = Sin(x, 14); return c * c + s * s; }, xs));
+        row("std::cos (long double)", time_calls([](double x) { return std::cos(static_cast<long double>(x)); }, xs, n, sink),
+            agreement([](double x) { return std::cos(static_cast<long double>(x)); }, cos_dd, xs));
+        std::cout << std::endl;
+
+        xs = inputs(0.5, 1.5);
+        auto pow_dd = [](double x) { return Pow(x, 100); };
+        header("Pow, x^100, x in [0.5, 1.5]");
+        row("DoubleDouble::Pow(x, 100)", time_calls([&](double x) { return pow_dd(x).hi; }, xs, n, sink),
+            residual([&](double x) { return pow_dd(x) * Pow(x, -100); }, xs));
+        row("std::pow (long double)", time_calls([](double x) { return std::pow(static_cast<long double>(x), 100); }, xs, n, sink),
+            agreement([](double x) { return std::pow(static_cast<long double>(x), 100); }, pow_dd, xs));
+        row("std::pow", time_calls([](double x) { return std::pow(x, 100); }, xs, n, sink),
+            agreement([](double x) { return std::pow(x, 100); }, pow_dd, xs));
+        row("Inline::Pow(x, 100)", time_calls([](double x) { return Inline::Pow(x, 100); }, xs, n, sink),
+            agreement([](double x) { return Inline::Pow(x, 100); }, pow_dd, xs));
+        std::cout << std::endl;
+
+        // x used as n in [0, 100]
+        xs = inputs(0.0, 101.0);
+        auto factorial_dd = [](double x) { return Factorial(static_cast<int>(x)); };
+        auto factorial_ld = [](double x) {
+            long double f = 1.0L;
+            for(int i = 2; i <= static_cast<int>(x); ++i) f *= i;
+            return f;
+        };
+        header("Factorial, n in [0, 100]");
+        row("DoubleDouble::Factorial", time_calls([&](double x) { return factorial_dd(x).hi; }, xs, n, sink),
+            residual([&](double x) {
+                Number r = 1.0;
+                for(int i = static_cast<int>(x); i >= 2; --i) r = r * static_cast<double>(i);
+                return factorial_dd(x) / r; }, xs));
+        row("long double loop", time_calls(factorial_ld, xs, n, sink), agreement(factorial_ld, factorial_dd, xs));
+        row("Inline::Factorial", time_calls([](double x) { return Inline::Factorial(static_cast<int>(x)); }, xs, n, sink),
+            agreement([](double x) { return Inline::Factorial(static_cast<int>(x)); }, factorial_dd, xs));
+        std::cout << std::endl;
+
+        std::cout << "(" << std::defaultfloat << sink << ")" << std::endl;
+    }
+
+}
+
+#endif //DOUBLEDOUBLE_HPP
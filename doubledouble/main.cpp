@@ -0,0 +1,17 @@
+#include <iostream>
+
+#include "doubledouble.hpp"
+
+int main(int argc, char ** argv)
+{
+    if(argc > 1)
+    {
+        std::cout << "Computing " << atoi(argv[1]) << " calls per variant : \n" << std::endl;
+        DoubleDouble::benchmark(atoi(argv[1]));
+    }
+    else
+    {
+        std::cout << "./doubledouble <loop_count>" << std::endl;
+    }
+    return 0;
+}
@@ -7,6 +7,7 @@
 
 #include "../pow/pow.hpp"
 #include "../factorial/factorial.hpp"
+#include "../profile/profile.hpp"
 
 // N or n is the order => precision of the result
 
@@ -17,11 +18,12 @@ namespace Normal {
 
     double Exp_(double x, int n)
     {
-        return n == 0 ? 1.0 : Exp_(x, n - 1) + Pow(x, n) / Factorial(n);
+        return n == 0 ? 1.0 : Exp_(x, n - 1) + Pow_(x, n) / Factorial_(n);
     }
 
     double Exp(double x, int n)
     {
+        TMP_PROFILE_SCOPE("Normal::Exp", n);
         return x < 0.0 ? 1.0 / Exp_(-x, n) : Exp_(x, n);
     }
 
@@ -33,11 +35,12 @@ namespace Inline {
 
     inline double Exp_(double x, int n)
     {
-        return n == 0 ? 1.0 : Exp_(x, n - 1) + Pow(x, n) / Factorial(n);
+        return n == 0 ? 1.0 : Exp_(x, n - 1) + Pow_(x, n) / Factorial_(n);
     }
 
     inline double Exp(double x, int n)
     {
+        TMP_PROFILE_SCOPE("Inline::Exp", n);
         return x < 0.0 ? 1.0 / Exp_(-x, n) : Exp_(x, n);
     }
 
@@ -52,7 +55,7 @@ namespace RecursiveTemplateFunc {
     template <int N>
     inline double Exp_(double x)
     {
-        return Exp_<N - 1>(x) + Pow<N>(x) / Factorial<N>();
+        return Exp_<N - 1>(x) + Pow_<N>(x) / Factorial_<N>();
     }
 
     template <>
@@ -64,6 +67,7 @@ namespace RecursiveTemplateFunc {
     template <int N>
     inline double Exp(double x)
     {
+        TMP_PROFILE_SCOPE("RecursiveTemplateFunc::Exp", N);
         return x < 0.0 ? 1.0 / Exp_<N>(-x) : Exp_<N>(x);
     }
 
@@ -104,6 +108,80 @@ namespace RecursiveTemplateStruct {
                                             Exp_<X, N>::Value;
 }
 
+//==============================================================================
+// Shallow recursive struct Exponential: logarithmic instantiation depth
+//==============================================================================
+namespace ShallowTemplateStruct {
+
+    // Terms of the series from the ratio of consecutive terms, X / I, instead
+    // of one Pow<X, I> and one Factorial<I> per term. Over [Lo, Hi], split in
+    // halves at M:
+    //
+    //     Ratio = (X / Lo) * ... * (X / Hi)
+    //     Sum   = X / Lo + (X / Lo) (X / (Lo + 1)) + ... + Ratio
+    //           = Sum[Lo, M] + Ratio[Lo, M] * Sum[M + 1, Hi]
+    //
+    // i.e. the terms Lo to Hi divided by the term Lo - 1. The additions are
+    // nested from the right instead of left to right: the result can differ
+    // from RecursiveTemplateStruct in the last bits.
+    template <int X, int Lo, int Hi>
+    struct ExpSum
+    {
+        static const double Ratio;
+        static const double Sum;
+    };
+
+    template <int X, int Lo, int Hi>
+    double const ExpSum<X, Lo, Hi>::Ratio = ExpSum<X, Lo, (Lo + Hi) / 2>::Ratio *
+                                            ExpSum<X, (Lo + Hi) / 2 + 1, Hi>::Ratio;
+
+    template <int X, int Lo, int Hi>
+    double const ExpSum<X, Lo, Hi>::Sum = ExpSum<X, Lo, (Lo + Hi) / 2>::Sum +
+                                          ExpSum<X, Lo, (Lo + Hi) / 2>::Ratio *
+                                          ExpSum<X, (Lo + Hi) / 2 + 1, Hi>::Sum;
+
+    template <int X, int I>
+    struct ExpSum<X, I, I>
+    {
+        static const double Ratio;
+        static const double Sum;
+    };
+
+    template <int X, int I>
+    double const ExpSum<X, I, I>::Ratio = static_cast<double>(X) / I;
+
+    template <int X, int I>
+    double const ExpSum<X, I, I>::Sum = static_cast<double>(X) / I;
+
+    template <int X, int N>
+    struct Exp_
+    {
+        static const double Value;
+    };
+
+    template <int X, int N>
+    double const Exp_<X, N>::Value = 1.0 + ExpSum<X, 1, N>::Sum;
+
+    template <int X>
+    struct Exp_<X, 0>
+    {
+        static const double Value;
+    };
+
+    template <int X>
+    double const Exp_<X, 0>::Value = 1.0;
+
+    template <int X, int N>
+    struct Exp
+    {
+        static const double Value;
+    };
+
+    template <int X, int N>
+    double const Exp<X, N>::Value = X < 0 ? 1.0 / Exp_<-X, N>::Value :
+                                            Exp_<X, N>::Value;
+}
+
 //==============================================================================
 // Constexpr Function Exponential
 //==============================================================================
@@ -111,12 +189,13 @@ namespace Constexpr {
 
     constexpr double Exp_(double x, int n)
     {
-        return n == 0 ? 1.0 : Exp_(x, n - 1) + Pow(x, n) / Factorial(n);
+        return n == 0 ? 1.0 : Exp_(x, n - 1) + Pow_(x, n) / Factorial_(n);
     }
 
     constexpr double Exp(double x, int n)
     {
-        return x < 0.0 ? 1.0 / Exp_(-x, n) : Exp_(x, n);
+        return TMP_PROFILE_COUNT("Constexpr::Exp", n),
+               x < 0.0 ? 1.0 / Exp_(-x, n) : Exp_(x, n);
     }
 
 }
@@ -156,7 +235,54 @@ double ExpTable<SIZE, 0>::array[SIZE] = { exp_func(0) };
 
 template struct ExpTable<EXP_ARRAY_SIZE>;
 
-static double const * exponentials = ExpTable<EXP_ARRAY_SIZE>::array;
+static auto const exponentials = TMP_PROFILE_TABLE("CompileTimeArray::exponentials", ExpTable<EXP_ARRAY_SIZE>::array);
+
+}
+
+//==============================================================================
+// Shallow compile-time generated array of exponentials
+//==============================================================================
+namespace ShallowCompileTimeArray {
+
+template <int SIZE>
+struct ExpTable
+{
+    static double array[SIZE];
+
+    static bool const filled;
+};
+
+// array[N] = exp_func(N) for N in [Lo, Hi], split in halves down to blocks of 16
+template <int SIZE, int Lo, int Hi, bool Block = (Hi - Lo < 16)>
+struct ExpFill
+{
+    static bool Do()
+    {
+        return ExpFill<SIZE, Lo, (Lo + Hi) / 2>::Do() &&
+               ExpFill<SIZE, (Lo + Hi) / 2 + 1, Hi>::Do();
+    }
+};
+
+template <int SIZE, int Lo, int Hi>
+struct ExpFill<SIZE, Lo, Hi, true>
+{
+    static bool Do()
+    {
+        for(int n = Lo; n <= Hi; ++n)
+            ExpTable<SIZE>::array[n] = CompileTimeArray::exp_func(n);
+        return true;
+    }
+};
+
+template <int SIZE>
+double ExpTable<SIZE>::array[SIZE];
+
+template <int SIZE>
+bool const ExpTable<SIZE>::filled = ExpFill<SIZE, 0, SIZE - 1>::Do();
+
+template struct ExpTable<EXP_ARRAY_SIZE>;
+
+static auto const exponentials = TMP_PROFILE_TABLE("ShallowCompileTimeArray::exponentials", ExpTable<EXP_ARRAY_SIZE>::array);
 
 }
 
@@ -171,7 +297,9 @@ namespace Exp {
         std::cout << Inline::Exp(42, 100) << std::endl;
         std::cout << RecursiveTemplateFunc::Exp<100>(42) << std::endl;
         std::cout << RecursiveTemplateStruct::Exp<42, 100>::Value << std::endl;
+        std::cout << ShallowTemplateStruct::Exp<42, 100>::Value << std::endl;
         std::cout << CompileTimeArray::exponentials[42] << std::endl;
+        std::cout << ShallowCompileTimeArray::exponentials[42] << std::endl;
         std::cout << Constexpr::Exp(42, 100) << std::endl;
         std::cout << std::exp(42) << std::endl;
         std::cout << std::endl;
@@ -212,6 +340,15 @@ namespace Exp {
         dur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
         std::cout << "Recursive template struct : " << dur.count() << "ms" << std::endl;
 
+        start = std::chrono::high_resolution_clock::now();
+        for(int i = 0; i < n; ++i)
+        {
+            auto p = ShallowTemplateStruct::Exp<42, 100>::Value;
+        }
+        end = std::chrono::high_resolution_clock::now();
+        dur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        std::cout << "Shallow template struct : " << dur.count() << "ms" << std::endl;
+
         start = std::chrono::high_resolution_clock::now();
         for(int i = 0; i < n; ++i)
         {
@@ -221,6 +358,15 @@ namespace Exp {
         dur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
         std::cout << "Compile-time array : " << dur.count() << "ms" << std::endl;
 
+        start = std::chrono::high_resolution_clock::now();
+        for(int i = 0; i < n; ++i)
+        {
+            auto p = ShallowCompileTimeArray::exponentials[100];
+        }
+        end = std::chrono::high_resolution_clock::now();
+        dur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        std::cout << "Shallow compile-time array : " << dur.count() << "ms" << std::endl;
+
         start = std::chrono::high_resolution_clock::now();
         for(int i = 0; i < n; ++i)
         {
@@ -5,14 +5,22 @@
 #include <chrono>
 #include <cmath>
 
+#include "../profile/profile.hpp"
+
 //==============================================================================
 // Function Factorial
 //==============================================================================
 namespace Normal {
 
+    double Factorial_(int n)
+    {
+        return n == 0 ? 1.0 : n * Factorial_(n - 1);
+    }
+
     double Factorial(int n)
     {
-        return n == 0 ? 1.0 : n * Factorial(n - 1);
+        TMP_PROFILE_SCOPE("Normal::Factorial", n);
+        return Factorial_(n);
     }
 
 }
@@ -21,9 +29,15 @@ namespace Normal {
 //==============================================================================
 namespace Inline {
 
+    inline double Factorial_(int n)
+    {
+        return n == 0 ? 1.0 : n * Factorial_(n - 1);
+    }
+
     inline double Factorial(int n)
     {
-        return n == 0 ? 1.0 : n * Factorial(n - 1);
+        TMP_PROFILE_SCOPE("Inline::Factorial", n);
+        return Factorial_(n);
     }
 
 }
@@ -34,17 +48,24 @@ namespace Inline {
 namespace RecursiveTemplateFunc {
 
     template <int N>
-    inline double Factorial()
+    inline double Factorial_()
     {
-        return N * Factorial<N - 1>();
+        return N * Factorial_<N - 1>();
     }
 
     template <>
-    inline double Factorial<0>()
+    inline double Factorial_<0>()
     {
         return 1.0;
     }
 
+    template <int N>
+    inline double Factorial()
+    {
+        TMP_PROFILE_SCOPE("RecursiveTemplateFunc::Factorial", N);
+        return Factorial_<N>();
+    }
+
 }
 
 //==============================================================================
@@ -71,14 +92,67 @@ namespace RecursiveTemplateStruct {
 
 }
 
+//==============================================================================
+// Shallow recursive struct Factorial: logarithmic instantiation depth
+//==============================================================================
+namespace ShallowTemplateStruct {
+
+    // Lo * (Lo + 1) * ... * Hi, split in halves
+    template <int Lo, int Hi>
+    struct Product
+    {
+        static const double Value;
+    };
+
+    template <int Lo, int Hi>
+    double const Product<Lo, Hi>::Value = Product<Lo, (Lo + Hi) / 2>::Value *
+                                          Product<(Lo + Hi) / 2 + 1, Hi>::Value;
+
+    template <int I>
+    struct Product<I, I>
+    {
+        static const double Value;
+    };
+
+    template <int I>
+    double const Product<I, I>::Value = I;
+
+    // N! = M! * (M + 1) * ... * N, with M = N without its lowest set bit: the
+    // products are over blocks aligned on powers of 2, shared by all the
+    // factorials, and there are at most log2(N) M.
+    template <int N>
+    struct Factorial
+    {
+        static const double Value;
+    };
+
+    template <int N>
+    double const Factorial<N>::Value = Factorial<(N & (N - 1))>::Value *
+                                       Product<(N & (N - 1)) + 1, N>::Value;
+
+    template <>
+    struct Factorial<0>
+    {
+        static const double Value;
+    };
+
+    double const Factorial<0>::Value = 1.0;
+
+}
+
 //==============================================================================
 // Constexpr Function Factorial
 //==============================================================================
 namespace Constexpr {
 
+    constexpr double Factorial_(int n)
+    {
+        return n == 0 ? 1.0 : n * Factorial_(n - 1);
+    }
+
     constexpr double Factorial(int n)
     {
-        return n == 0 ? 1.0 : n * Factorial(n - 1);
+        return TMP_PROFILE_COUNT("Constexpr::Factorial", n), Factorial_(n);
     }
 
 }
@@ -116,7 +190,53 @@ namespace CompileTimeArray {
 
     template struct Table<FACT_ARRAY_SIZE>;
 
-    static double const * factorials = Table<FACT_ARRAY_SIZE>::array;
+    static auto const factorials = TMP_PROFILE_TABLE("CompileTimeArray::factorials", Table<FACT_ARRAY_SIZE>::array);
+
+}
+
+//==============================================================================
+// Shallow compile-time generated array of factorials
+//==============================================================================
+namespace ShallowCompileTimeArray {
+
+    template <int N>
+    struct Table
+    {
+        static double array[N];
+        static bool const filled;
+    };
+
+    // array[I] = I * array[I - 1] for I in [Lo, Hi], in increasing order as
+    // the Table chain does, but split in halves down to blocks of 16
+    template <int N, int Lo, int Hi, bool Block = (Hi - Lo < 16)>
+    struct Fill
+    {
+        static bool Do()
+        {
+            return Fill<N, Lo, (Lo + Hi) / 2>::Do() && Fill<N, (Lo + Hi) / 2 + 1, Hi>::Do();
+        }
+    };
+
+    template <int N, int Lo, int Hi>
+    struct Fill<N, Lo, Hi, true>
+    {
+        static bool Do()
+        {
+            for(int i = Lo; i <= Hi; ++i)
+                Table<N>::array[i] = i * Table<N>::array[i - 1];
+            return true;
+        }
+    };
+
+    template <int N>
+    double Table<N>::array[N] = { 1 }; // Initial value (I = 0)
+
+    template <int N>
+    bool const Table<N>::filled = Fill<N, 1, N - 1>::Do();
+
+    template struct Table<FACT_ARRAY_SIZE>;
+
+    static auto const factorials = TMP_PROFILE_TABLE("ShallowCompileTimeArray::factorials", Table<FACT_ARRAY_SIZE>::array);
 
 }
 
@@ -163,6 +283,15 @@ namespace Factorial {
         dur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
         std::cout << "Recursive template struct : " << dur.count() << "ms" << std::endl;
 
+        start = std::chrono::high_resolution_clock::now();
+        for(int i = 0; i < n; ++i)
+        {
+            auto f = ShallowTemplateStruct::Factorial<100>::Value;
+        }
+        end = std::chrono::high_resolution_clock::now();
+        dur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        std::cout << "Shallow template struct : " << dur.count() << "ms" << std::endl;
+
         start = std::chrono::high_resolution_clock::now();
         for(int i = 0; i < n; ++i)
         {
@@ -174,6 +303,15 @@ namespace Factorial {
         dur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
         std::cout << "Compile-time array : " << dur.count() << "ms" << std::endl;
 
+        start = std::chrono::high_resolution_clock::now();
+        for(int i = 0; i < n; ++i)
+        {
+            auto f = ShallowCompileTimeArray::factorials[100];
+        }
+        end = std::chrono::high_resolution_clock::now();
+        dur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        std::cout << "Shallow compile-time array : " << dur.count() << "ms" << std::endl;
+
         start = std::chrono::high_resolution_clock::now();
         for(int i = 0; i < n; ++i)
         {
@@ -1,3 +1,13 @@
+#ifndef LOOP_HPP
+#define LOOP_HPP
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
 template <int Begin, int End>
 struct Loop
 {
@@ -13,3 +23,361 @@ struct Loop<N, N>
 {
     static void Do() { }
 };
+
+//==============================================================================
+// Unrolled loops with a body
+//==============================================================================
+
+// Body::Do<I>(args...) for I in [Begin, End)
+template <int Begin, int End, typename Body>
+struct Loop1D
+{
+    template <typename... Args>
+    static void Do(Args... args)
+    {
+        Body::template Do<Begin>(args...);
+        Loop1D<Begin + 1, End, Body>::Do(args...);
+    }
+};
+
+template <int N, typename Body>
+struct Loop1D<N, N, Body>
+{
+    template <typename... Args>
+    static void Do(Args...) { }
+};
+
+// Body::Do<I, J>(args...) for J in [JBegin, JEnd)
+template <int I, int JBegin, int JEnd, typename Body>
+struct Loop2DRow
+{
+    template <typename... Args>
+    static void Do(Args... args)
+    {
+        Body::template Do<I, JBegin>(args...);
+        Loop2DRow<I, JBegin + 1, JEnd, Body>::Do(args...);
+    }
+};
+
+template <int I, int J, typename Body>
+struct Loop2DRow<I, J, J, Body>
+{
+    template <typename... Args>
+    static void Do(Args...) { }
+};
+
+// Body::Do<I, J>(args...) for I in [IBegin, IEnd), J in [JBegin, JEnd),
+// row by row (J innermost)
+template <int IBegin, int IEnd, int JBegin, int JEnd, typename Body>
+struct Loop2D
+{
+    template <typename... Args>
+    static void Do(Args... args)
+    {
+        Loop2DRow<IBegin, JBegin, JEnd, Body>::Do(args...);
+        Loop2D<IBegin + 1, IEnd, JBegin, JEnd, Body>::Do(args...);
+    }
+};
+
+template <int I, int JBegin, int JEnd, typename Body>
+struct Loop2D<I, I, JBegin, JEnd, Body>
+{
+    template <typename... Args>
+    static void Do(Args...) { }
+};
+
+// Tile (I, J) of Loop2D -> tile origin
+template <int IBegin, int JBegin, int TI, int TJ, typename Body>
+struct TileOrigin
+{
+    template <int I, int J, typename... Args>
+    static void Do(Args... args)
+    {
+        Body::template Do<IBegin + I * TI, JBegin + J * TJ>(args...);
+    }
+};
+
+// Body::Do<I0, J0>(args...) for the origins (I0, J0) of the TI x TJ tiles
+// covering [IBegin, IEnd) x [JBegin, JEnd)
+template <int IBegin, int IEnd, int JBegin, int JEnd, int TI, int TJ, typename Body>
+struct TiledLoop
+{
+    static_assert((IEnd - IBegin) % TI == 0 && (JEnd - JBegin) % TJ == 0,
+                  "The tiles must cover the range exactly");
+
+    template <typename... Args>
+    static void Do(Args... args)
+    {
+        Loop2D<0, (IEnd - IBegin) / TI, 0, (JEnd - JBegin) / TJ,
+               TileOrigin<IBegin, JBegin, TI, TJ, Body>>::Do(args...);
+    }
+};
+
+// Matrix multiply, C (M x N) = A (M x K) * B (K x N), row-major
+
+//==============================================================================
+// Runtime loops
+//==============================================================================
+namespace Normal {
+
+    void MatMul(double * c, double const * a, double const * b, int m, int n, int k)
+    {
+        for(int i = 0; i < m; ++i)
+            for(int j = 0; j < n; ++j)
+            {
+                double s = 0.0;
+                for(int l = 0; l < k; ++l)
+                    s += a[i * k + l] * b[l * n + j];
+                c[i * n + j] = s;
+            }
+    }
+
+}
+
+//==============================================================================
+// Hand-written: 3x3 and 4x4 written out, 4x4 register blocks otherwise
+//==============================================================================
+namespace HandWritten {
+
+    template <int M, int N, int K>
+    inline void MatMul(double * c, double const * a, double const * b)
+    {
+        static_assert(M % 4 == 0 && N % 4 == 0, "4x4 blocks");
+
+        for(int i = 0; i < M; i += 4)
+            for(int j = 0; j < N; j += 4)
+            {
+                double acc[4][4] = { };
+                for(int k = 0; k < K; ++k)
+                    for(int ii = 0; ii < 4; ++ii)
+                        for(int jj = 0; jj < 4; ++jj)
+                            acc[ii][jj] += a[(i + ii) * K + k] * b[k * N + j + jj];
+                for(int ii = 0; ii < 4; ++ii)
+                    for(int jj = 0; jj < 4; ++jj)
+                        c[(i + ii) * N + j + jj] = acc[ii][jj];
+            }
+    }
+
+    template <>
+    inline void MatMul<3, 3, 3>(double * c, double const * a, double const * b)
+    {
+        c[0] = a[0] * b[0] + a[1] * b[3] + a[2] * b[6];
+        c[1] = a[0] * b[1] + a[1] * b[4] + a[2] * b[7];
+        c[2] = a[0] * b[2] + a[1] * b[5] + a[2] * b[8];
+        c[3] = a[3] * b[0] + a[4] * b[3] + a[5] * b[6];
+        c[4] = a[3] * b[1] + a[4] * b[4] + a[5] * b[7];
+        c[5] = a[3] * b[2] + a[4] * b[5] + a[5] * b[8];
+        c[6] = a[6] * b[0] + a[7] * b[3] + a[8] * b[6];
+        c[7] = a[6] * b[1] + a[7] * b[4] + a[8] * b[7];
+        c[8] = a[6] * b[2] + a[7] * b[5] + a[8] * b[8];
+    }
+
+    template <>
+    inline void MatMul<4, 4, 4>(double * c, double const * a, double const * b)
+    {
+        for(int i = 0; i < 4; ++i)
+        {
+            double const * r = a + 4 * i;
+            c[4 * i + 0] = r[0] * b[0] + r[1] * b[4] + r[2] * b[8]  + r[3] * b[12];
+            c[4 * i + 1] = r[0] * b[1] + r[1] * b[5] + r[2] * b[9]  + r[3] * b[13];
+            c[4 * i + 2] = r[0] * b[2] + r[1] * b[6] + r[2] * b[10] + r[3] * b[14];
+            c[4 * i + 3] = r[0] * b[3] + r[1] * b[7] + r[2] * b[11] + r[3] * b[15];
+        }
+    }
+
+}
+
+//==============================================================================
+// Fully unrolled: one dot product per entry
+//==============================================================================
+namespace Unrolled {
+
+    template <int N, int K, int I, int J>
+    struct DotTerm
+    {
+        template <int L>
+        static void Do(double * s, double const * a, double const * b)
+        {
+            *s += a[I * K + L] * b[L * N + J];
+        }
+    };
+
+    template <int N, int K>
+    struct Entry
+    {
+        template <int I, int J>
+        static void Do(double * c, double const * a, double const * b)
+        {
+            double s = 0.0;
+            Loop1D<0, K, DotTerm<N, K, I, J>>::Do(&s, a, b);
+            c[I * N + J] = s;
+        }
+    };
+
+    template <int M, int N, int K>
+    inline void MatMul(double * c, double const * a, double const * b)
+    {
+        Loop2D<0, M, 0, N, Entry<N, K>>::Do(c, a, b);
+    }
+
+}
+
+//==============================================================================
+// Tiled: TM x TN accumulators per tile, rank-1 updates over K
+//==============================================================================
+namespace Tiled {
+
+    // acc[I][J] += a[I][0] * b[0][J]: the J are contiguous in acc and b, so
+    // that each row of the tile is a vector operation
+    template <int K, int TN>
+    struct MulAdd
+    {
+        template <int I, int J>
+        static void Do(double * acc, double const * a, double const * b)
+        {
+            acc[I * TN + J] += a[I * K] * b[J];
+        }
+    };
+
+    template <int N, int TN>
+    struct Store
+    {
+        template <int I, int J>
+        static void Do(double * c, double const * acc)
+        {
+            c[I * N + J] = acc[I * TN + J];
+        }
+    };
+
+    template <int N, int K, int TM, int TN>
+    struct MicroKernel
+    {
+        template <int I0, int J0>
+        static void Do(double * c, double const * a, double const * b)
+        {
+            double acc[TM * TN] = { };
+            for(int k = 0; k < K; ++k)
+                Loop2D<0, TM, 0, TN, MulAdd<K, TN>>::Do(acc, a + I0 * K + k, b + k * N + J0);
+            Loop2D<0, TM, 0, TN, Store<N, TN>>::Do(c + I0 * N + J0, acc);
+        }
+    };
+
+    template <int M, int N, int K, int TM, int TN>
+    inline void MatMul(double * c, double const * a, double const * b)
+    {
+        TiledLoop<0, M, 0, N, TM, TN, MicroKernel<N, K, TM, TN>>::Do(c, a, b);
+    }
+
+    // Same kernel, the tiles in runtime loops: the code size stays that of one
+    // tile for the large matrices
+    template <int M, int N, int K, int TM, int TN>
+    inline void BlockedMatMul(double * c, double const * a, double const * b)
+    {
+        static_assert(M % TM == 0 && N % TN == 0, "The tiles must cover the matrix exactly");
+
+        for(int i = 0; i < M; i += TM)
+            for(int j = 0; j < N; j += TN)
+                MicroKernel<N, K, TM, TN>::template Do<0, 0>(c + i * N + j, a + i * K, b + j);
+    }
+
+}
+
+//==============================================================================
+// Minimalist benchmark
+//==============================================================================
+namespace MatMul {
+
+    // Cycles through COUNT pairs of random matrices, so that the products can
+    // not be hoisted out of the loop
+    static int const COUNT = 64;
+
+    template <typename F>
+    double time_ns(F f, int n, std::vector<double> & c, std::vector<double> const & a,
+                   std::vector<double> const & b, int msize, int asize, int bsize, double & sink)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        for(int i = 0; i < n; ++i)
+        {
+            int p = i % COUNT;
+            f(&c[p * msize], &a[p * asize], &b[p * bsize]);
+            sink += c[p * msize];
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / n;
+    }
+
+    double max_error(std::vector<double> const & c, std::vector<double> const & ref)
+    {
+        double e = 0.0;
+        for(std::size_t i = 0; i < c.size(); ++i)
+            e = std::max(e, std::abs(c[i] - ref[i]));
+        return e;
+    }
+
+    // UNROLLED: whether to time the fully unrolled variant (M * N * K terms)
+    template <int M, int N, int K, int TM, int TN, bool UNROLLED>
+    void benchmark_size(int n, double & sink)
+    {
+        std::vector<double> a(COUNT * M * K), b(COUNT * K * N), ref(COUNT * M * N), c(COUNT * M * N);
+        for(auto & x : a) x = std::rand() / (double)RAND_MAX - 0.5;
+        for(auto & x : b) x = std::rand() / (double)RAND_MAX - 0.5;
+
+        // Read back so that the naive loops keep runtime bounds
+        volatile int dims[3] = { M, N, K };
+        int m = dims[0], nn = dims[1], k = dims[2];
+
+        auto normal = [=](double * c, double const * a, double const * b) { Normal::MatMul(c, a, b, m, nn, k); };
+        auto hand = [](double * c, double const * a, double const * b) { HandWritten::MatMul<M, N, K>(c, a, b); };
+        auto unrolled = [](double * c, double const * a, double const * b) { Unrolled::MatMul<M, N, K>(c, a, b); };
+        auto tiled = [](double * c, double const * a, double const * b) { Tiled::MatMul<M, N, K, TM, TN>(c, a, b); };
+        auto blocked = [](double * c, double const * a, double const * b) { Tiled::BlockedMatMul<M, N, K, TM, TN>(c, a, b); };
+
+        double t_normal = time_ns(normal, n, ref, a, b, M * N, M * K, K * N, sink);
+        double t_hand = time_ns(hand, n, c, a, b, M * N, M * K, K * N, sink);
+        double error = max_error(c, ref);
+        double t_unrolled = 0.0;
+        if(UNROLLED)
+        {
+            t_unrolled = time_ns(unrolled, n, c, a, b, M * N, M * K, K * N, sink);
+            error = std::max(error, max_error(c, ref));
+        }
+        double t_tiled = time_ns(tiled, n, c, a, b, M * N, M * K, K * N, sink);
+        error = std::max(error, max_error(c, ref));
+        double t_blocked = time_ns(blocked, n, c, a, b, M * N, M * K, K * N, sink);
+        error = std::max(error, max_error(c, ref));
+
+        std::cout << std::setw(3) << M << "x" << std::setw(2) << N << "x" << std::setw(2) << K
+                  << std::setw(4) << TM << "x" << TN
+                  << std::setw(12) << t_normal << std::setw(12) << t_hand;
+        if(UNROLLED)
+            std::cout << std::setw(12) << t_unrolled;
+        else
+            std::cout << std::setw(12) << "-";
+        std::cout << std::setw(12) << t_tiled << std::setw(12) << t_blocked
+                  << std::setw(12) << std::scientific
+                  << std::setprecision(1) << error << std::fixed << std::setprecision(2)
+                  << std::endl;
+    }
+
+    void benchmark(int n)
+    {
+        std::cout << "ns per multiply (tile = TM x TN of the tiled variants)" << std::endl << std::endl;
+        std::cout << std::setw(9) << "size" << std::setw(6) << "tile"
+                  << std::setw(12) << "normal" << std::setw(12) << "hand"
+                  << std::setw(12) << "unrolled" << std::setw(12) << "tiled"
+                  << std::setw(12) << "blocked"
+                  << std::setw(12) << "max error" << std::endl;
+
+        double sink = 0.0;
+        std::cout << std::fixed << std::setprecision(2);
+        benchmark_size<3, 3, 3, 3, 3, true>(n, sink);
+        benchmark_size<4, 4, 4, 4, 4, true>(n, sink);
+        benchmark_size<8, 8, 8, 4, 4, true>(n, sink);
+        benchmark_size<16, 16, 16, 4, 4, false>(n / 8, sink);
+        benchmark_size<32, 32, 32, 4, 4, false>(n / 64, sink);
+        std::cout << std::endl << "(" << sink << ")" << std::endl;
+    }
+
+}
+
+#endif //LOOP_HPP
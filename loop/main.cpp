@@ -1,8 +1,19 @@
+#include <iostream>
+
 #include "loop.hpp"
 
-int main()
+int main(int argc, char ** argv)
 {
     Loop<1, 10>::Do();
 
+    if(argc > 1)
+    {
+        std::cout << "Computing " << atoi(argv[1]) << " matrix multiplies per size : \n" << std::endl;
+        MatMul::benchmark(atoi(argv[1]));
+    }
+    else
+    {
+        std::cout << "./loop <loop_count>" << std::endl;
+    }
     return 0;
 }
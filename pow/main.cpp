@@ -1,17 +1,23 @@
+#include <cstring>
 #include <iostream>
 
 #include "pow.hpp"
 
 int main(int argc, char ** argv)
 {
-    if(argc > 1)
+    if(argc > 2 && !strcmp(argv[2], "batch"))
+    {
+        std::cout << "Computing " << atoi(argv[1]) << " powers x[i]^n[i] per variant : \n" << std::endl;
+        Pow::batch_benchmark(atoi(argv[1]));
+    }
+    else if(argc > 1)
     {
         std::cout << "Computing " << atoi(argv[1]) << " times 2^100 : \n" << std::endl;
         Pow::benchmark(atoi(argv[1]));
     }
     else
     {
-        std::cout << "./pow <loop_count>" << std::endl;
+        std::cout << "./pow <loop_count> [batch]" << std::endl;
     }
     return 0;
 }
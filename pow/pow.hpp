@@ -1,18 +1,32 @@
 #ifndef POW_HPP
 #define POW_HPP
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
 #include <iostream>
+#include <vector>
+
+#include "../profile/profile.hpp"
 
 //==============================================================================
 // Function Power
 //==============================================================================
 namespace Normal {
 
+    double Pow_(double x, int n)
+    {
+        return n == 0 ? 1 : x * Pow_(x, n - 1);
+    }
+
     double Pow(double x, int n)
     {
-        return n == 0 ? 1 : x * Pow(x, n - 1);
+        TMP_PROFILE_SCOPE("Normal::Pow", n);
+        return Pow_(x, n);
     }
 
 }
@@ -21,9 +35,15 @@ namespace Normal {
 //==============================================================================
 namespace Inline {
 
+    inline double Pow_(double x, int n)
+    {
+        return n == 0 ? 1 : x * Pow_(x, n - 1);
+    }
+
     inline double Pow(double x, int n)
     {
-        return n == 0 ? 1 : x * Pow(x, n - 1);
+        TMP_PROFILE_SCOPE("Inline::Pow", n);
+        return Pow_(x, n);
     }
 
 }
@@ -34,17 +54,24 @@ namespace Inline {
 namespace RecursiveTemplateFunc {
 
     template <int N>
-    inline double Pow(double x)
+    inline double Pow_(double x)
     {
-        return x * Pow<N - 1>(x);
+        return x * Pow_<N - 1>(x);
     }
 
     template <>
-    inline double Pow<0>(double)
+    inline double Pow_<0>(double)
     {
         return 1.0;
     }
 
+    template <int N>
+    inline double Pow(double x)
+    {
+        TMP_PROFILE_SCOPE("RecursiveTemplateFunc::Pow", N);
+        return Pow_<N>(x);
+    }
+
 }
 
 //==============================================================================
@@ -72,14 +99,46 @@ namespace RecursiveTemplateStruct {
 
 }
 
+//==============================================================================
+// Shallow recursive struct Power: logarithmic instantiation depth
+//==============================================================================
+namespace ShallowTemplateStruct {
+
+    // X^N = (X^(N/2))^2 * X^(N%2)
+    template <int X, int N>
+    struct Pow
+    {
+        static const double Value;
+    };
+
+    template <int X, int N>
+    double const Pow<X, N>::Value = Pow<X, N / 2>::Value * Pow<X, N / 2>::Value *
+                                    (N % 2 ? static_cast<double>(X) : 1.0);
+
+    template <int X>
+    struct Pow<X, 0>
+    {
+        static const double Value;
+    };
+
+    template <int X>
+    double const Pow<X, 0>::Value = 1.0;
+
+}
+
 //==============================================================================
 // Constexpr Function Power
 //==============================================================================
 namespace Constexpr {
 
+    constexpr double Pow_(double x, int n)
+    {
+        return n == 0 ? 1.0 : x * Pow_(x, n - 1);
+    }
+
     constexpr double Pow(double x, int n)
     {
-        return n == 0 ? 1.0 : x * Pow(x, n - 1);
+        return TMP_PROFILE_COUNT("Constexpr::Pow", n), Pow_(x, n);
     }
 
 }
@@ -119,7 +178,171 @@ double PowTable<SIZE, 0>::array[SIZE] = { pow_func(0) };
 
 template struct PowTable<POW_ARRAY_SIZE>;
 
-static double const * powers = PowTable<POW_ARRAY_SIZE>::array;
+static auto const powers = TMP_PROFILE_TABLE("CompileTimeArray::powers", PowTable<POW_ARRAY_SIZE>::array);
+
+}
+
+//==============================================================================
+// Shallow compile-time generated array of powers
+//==============================================================================
+namespace ShallowCompileTimeArray {
+
+template <int SIZE>
+struct PowTable
+{
+    static double array[SIZE];
+
+    static bool const filled;
+};
+
+// array[N] = pow_func(N) for N in [Lo, Hi], split in halves down to blocks of 16
+template <int SIZE, int Lo, int Hi, bool Block = (Hi - Lo < 16)>
+struct PowFill
+{
+    static bool Do()
+    {
+        return PowFill<SIZE, Lo, (Lo + Hi) / 2>::Do() &&
+               PowFill<SIZE, (Lo + Hi) / 2 + 1, Hi>::Do();
+    }
+};
+
+template <int SIZE, int Lo, int Hi>
+struct PowFill<SIZE, Lo, Hi, true>
+{
+    static bool Do()
+    {
+        for(int n = Lo; n <= Hi; ++n)
+            PowTable<SIZE>::array[n] = CompileTimeArray::pow_func(n);
+        return true;
+    }
+};
+
+template <int SIZE>
+double PowTable<SIZE>::array[SIZE];
+
+template <int SIZE>
+bool const PowTable<SIZE>::filled = PowFill<SIZE, 0, SIZE - 1>::Do();
+
+template struct PowTable<POW_ARRAY_SIZE>;
+
+static auto const powers = TMP_PROFILE_TABLE("ShallowCompileTimeArray::powers", PowTable<POW_ARRAY_SIZE>::array);
+
+}
+
+//==============================================================================
+// Batch power with per-element integer exponents: out[i] = x[i]^n[i]
+//==============================================================================
+namespace Batch {
+
+    // LANES doubles, and LANES 64-bit exponents in the same lanes: one
+    // register (GCC vector extensions, AVX with -mavx or -march=native, SSE2
+    // otherwise; wider vectors would be split and spilled). The arithmetic,
+    // shifts and bitwise operations on them are element-wise SIMD operations:
+    // the compiler does not have to prove the loop vectorizable (it does not
+    // if-convert a ?: on the scalars without AVX, and fully unrolls the 16
+    // iterations before trying).
+#ifdef __AVX__
+    static int const VECTOR_BYTES = 32;
+#else
+    static int const VECTOR_BYTES = 16;
+#endif
+    typedef double Doubles __attribute__((vector_size(VECTOR_BYTES)));
+    typedef std::uint64_t Ints __attribute__((vector_size(VECTOR_BYTES)));
+
+    static int const LANES = sizeof(Doubles) / sizeof(double);
+
+    // Elements per block
+    static int const BLOCK = 16;
+    static int const VECTORS = BLOCK / LANES;
+
+    inline std::int64_t Abs(int n)
+    {
+        return n < 0 ? -static_cast<std::int64_t>(n) : n;
+    }
+
+    inline double Pow(double x, int n)
+    {
+        double r = 1.0;
+        for(std::int64_t e = Abs(n); e; e >>= 1, x *= x)
+            if(e & 1) r *= x;
+        return n < 0 ? 1.0 / r : r;
+    }
+
+    // Square-and-multiply of a block with the same exponent n: the bits of n
+    // are tested once for the whole block
+    inline void PowBlock(double const * x, int n, double * out)
+    {
+        Doubles r[VECTORS], b[VECTORS];
+        std::memcpy(b, x, sizeof b);
+        for(int v = 0; v < VECTORS; ++v) r[v] = Doubles() + 1.0;
+
+        for(std::int64_t e = Abs(n); e; e >>= 1)
+        {
+            if(e & 1)
+                for(int v = 0; v < VECTORS; ++v) r[v] *= b[v];
+            for(int v = 0; v < VECTORS; ++v) b[v] *= b[v];
+        }
+
+        if(n < 0)
+            for(int v = 0; v < VECTORS; ++v) r[v] = 1.0 / r[v];
+        std::memcpy(out, r, sizeof r);
+    }
+
+    // Square-and-multiply over the bits of the largest exponent of the block,
+    // each lane taking the product or keeping its result depending on its own
+    // bit: a bitwise blend under the mask -bit (all ones or all zeros). A ?:
+    // on the vectors needs a 64-bit compare, which SSE2 lacks: GCC lowers it
+    // to a branch per lane.
+    inline void PowBlock(double const * x, int const * n, double * out)
+    {
+        std::uint64_t a[BLOCK];
+        std::uint64_t bits = 0;
+        bool negative = false;
+        for(int j = 0; j < BLOCK; ++j)
+        {
+            a[j] = Abs(n[j]);
+            bits |= a[j];
+            negative |= n[j] < 0;
+        }
+
+        Doubles r[VECTORS], b[VECTORS];
+        Ints e[VECTORS];
+        std::memcpy(b, x, sizeof b);
+        std::memcpy(e, a, sizeof e);
+        for(int v = 0; v < VECTORS; ++v) r[v] = Doubles() + 1.0;
+
+        for(; bits; bits >>= 1)
+        {
+            for(int v = 0; v < VECTORS; ++v)
+            {
+                Ints take = -(e[v] & 1);
+                e[v] >>= 1;
+                Ints p = reinterpret_cast<Ints>(r[v] * b[v]);
+                r[v] = reinterpret_cast<Doubles>((p & take) | (reinterpret_cast<Ints>(r[v]) & ~take));
+                b[v] *= b[v];
+            }
+        }
+
+        // The divisions only for the blocks with negative exponents
+        std::memcpy(out, r, sizeof r);
+        if(negative)
+            for(int j = 0; j < BLOCK; ++j)
+                if(n[j] < 0) out[j] = 1.0 / out[j];
+    }
+
+    inline void Pow(double const * x, int const * n, double * out, std::size_t size)
+    {
+        std::size_t const blocks = size - size % BLOCK;
+        for(std::size_t i = 0; i < blocks; i += BLOCK)
+        {
+            bool same = true;
+            for(int j = 1; j < BLOCK; ++j) same &= n[i + j] == n[i];
+            if(same) PowBlock(x + i, n[i], out + i);
+            else PowBlock(x + i, n + i, out + i);
+        }
+        for(std::size_t i = blocks; i < size; ++i)
+            out[i] = Pow(x[i], n[i]);
+    }
 
 }
 
@@ -134,7 +357,9 @@ namespace Pow {
         std::cout << Inline::Pow(2, 100) << std::endl;
         std::cout << RecursiveTemplateFunc::Pow<100>(2) << std::endl;
         std::cout << RecursiveTemplateStruct::Pow<2, 100>::Value << std::endl;
+        std::cout << ShallowTemplateStruct::Pow<2, 100>::Value << std::endl;
         std::cout << CompileTimeArray::powers[100] << std::endl;
+        std::cout << ShallowCompileTimeArray::powers[100] << std::endl;
         std::cout << Constexpr::Pow(2, 100) << std::endl;
         std::cout << std::pow(2, 100) << std::endl;
         std::cout << std::endl;
@@ -175,6 +400,15 @@ namespace Pow {
         dur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
         std::cout << "Recursive template struct : " << dur.count() << "ms" << std::endl;
 
+        start = std::chrono::high_resolution_clock::now();
+        for(int i = 0; i < n; ++i)
+        {
+            auto p = ShallowTemplateStruct::Pow<2, 100>::Value;
+        }
+        end = std::chrono::high_resolution_clock::now();
+        dur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        std::cout << "Shallow template struct : " << dur.count() << "ms" << std::endl;
+
         start = std::chrono::high_resolution_clock::now();
         for(int i = 0; i < n; ++i)
         {
@@ -184,6 +418,15 @@ namespace Pow {
         dur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
         std::cout << "Compile-time array : " << dur.count() << "ms" << std::endl;
 
+        start = std::chrono::high_resolution_clock::now();
+        for(int i = 0; i < n; ++i)
+        {
+            auto p = ShallowCompileTimeArray::powers[100];
+        }
+        end = std::chrono::high_resolution_clock::now();
+        dur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        std::cout << "Shallow compile-time array : " << dur.count() << "ms" << std::endl;
+
         start = std::chrono::high_resolution_clock::now();
         for(int i = 0; i < n; ++i)
         {
@@ -196,6 +439,87 @@ namespace Pow {
         std::cout << "Constexpr : " << dur.count() << "ms" << std::endl;
     }
 
+    // ns per element of f(x, n, out, size) over size elements
+    template <typename F>
+    double time_batch(F f, std::vector<double> const & x, std::vector<int> const & n,
+                      std::vector<double> & out, int loops, double & sink)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        for(int l = 0; l < loops; ++l)
+        {
+            f(x.data(), n.data(), out.data(), x.size());
+            sink += out[l % out.size()];
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / (double(loops) * x.size());
+    }
+
+    // Max relative difference with std::pow
+    double max_error(std::vector<double> const & x, std::vector<int> const & n,
+                     std::vector<double> const & out)
+    {
+        double err = 0.0;
+        for(std::size_t i = 0; i < x.size(); ++i)
+        {
+            double p = std::pow(x[i], n[i]);
+            err = std::max(err, std::abs(out[i] - p) / std::abs(p));
+        }
+        return err;
+    }
+
+    void batch_benchmark(int n)
+    {
+        std::size_t const SIZE = 4096;
+        std::vector<double> x(SIZE), out(SIZE);
+        std::vector<int> mixed(SIZE), equal(SIZE, 11), negative(SIZE);
+        std::srand(42);
+        for(std::size_t i = 0; i < SIZE; ++i)
+        {
+            x[i] = 0.5 + std::rand() / (double)RAND_MAX;
+            mixed[i] = std::rand() % 17;
+            negative[i] = std::rand() % 33 - 16;
+        }
+
+        auto scalar = [](double const * x, int const * n, double * out, std::size_t size)
+        {
+            for(std::size_t i = 0; i < size; ++i)
+                out[i] = Inline::Pow(x[i], n[i]);
+        };
+        auto scalar_neg = [](double const * x, int const * n, double * out, std::size_t size)
+        {
+            for(std::size_t i = 0; i < size; ++i)
+                out[i] = n[i] < 0 ? 1.0 / Inline::Pow(x[i], -n[i]) : Inline::Pow(x[i], n[i]);
+        };
+        auto batch = [](double const * x, int const * n, double * out, std::size_t size)
+        {
+            Batch::Pow(x, n, out, size);
+        };
+
+        int loops = std::max(1, n / int(SIZE));
+        double sink = 0.0;
+        std::cout << std::setw(32) << std::left << "ns per element" << std::right
+                  << std::setw(10) << "scalar" << std::setw(10) << "batch"
+                  << std::setw(14) << "max error" << std::endl;
+
+        struct Case { char const * name; std::vector<int> const * n; bool neg; };
+        Case const cases[] = {
+            { "exponents in [0, 16]", &mixed, false },
+            { "exponents all 11", &equal, false },
+            { "exponents in [-16, 16]", &negative, true },
+        };
+        for(Case const & c : cases)
+        {
+            double ts = c.neg ? time_batch(scalar_neg, x, *c.n, out, loops, sink)
+                              : time_batch(scalar, x, *c.n, out, loops, sink);
+            double tb = time_batch(batch, x, *c.n, out, loops, sink);
+            std::cout << std::setw(32) << std::left << c.name << std::right
+                      << std::setw(10) << ts << std::setw(10) << tb
+                      << std::setw(14) << max_error(x, *c.n, out) << std::endl;
+        }
+
+        std::cout << std::endl << "(" << sink << ")" << std::endl;
+    }
+
 }
 
 #endif //POW_HPP
@@ -0,0 +1,93 @@
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "../cos/cos.hpp"
+#include "../exp/exp.hpp"
+
+// Calls a mix of variants from <threads> threads, reports the time per
+// iteration and, built with -DTMP_PROFILE, the merged profile.
+static void work(int n, int seed, double & sink)
+{
+    double s = 0.0;
+    for(int i = 0; i < n; ++i)
+    {
+        double x = ((i * 7919u + seed) % 1000u) / 1000.0;
+        s += Inline::Cos(x, 10);
+        s += RecursiveTemplateFunc::Exp<20>(x);
+        s += Constexpr::Pow(x, 8);
+        s += CompileTimeArray::factorials[i % 20];
+        if(i % 16 == 0) s += Normal::Exp(x, 12);
+    }
+    sink = s;
+}
+
+static long const MAX_THREADS = 256;
+
+static void usage()
+{
+    std::cerr << "./profile <loop_count> [threads]" << std::endl;
+}
+
+// strtol of the whole of s into [lo, hi]
+static bool parse(char const * s, long lo, long hi, long & value)
+{
+    char * end;
+    errno = 0;
+    value = std::strtol(s, &end, 10);
+    return end != s && !*end && errno == 0 && value >= lo && value <= hi;
+}
+
+int main(int argc, char ** argv)
+{
+    if(argc < 2 || argc > 3)
+    {
+        usage();
+        return 1;
+    }
+
+    long value;
+    if(!parse(argv[1], 1, INT_MAX, value))
+    {
+        std::cerr << "<loop_count> must be in [1, " << INT_MAX << "]" << std::endl;
+        usage();
+        return 1;
+    }
+    int n = static_cast<int>(value);
+
+    int threads = 1;
+    if(argc > 2)
+    {
+        if(!parse(argv[2], 1, MAX_THREADS, value))
+        {
+            std::cerr << "[threads] must be in [1, " << MAX_THREADS << "]" << std::endl;
+            usage();
+            return 1;
+        }
+        threads = static_cast<int>(value);
+    }
+
+    std::vector<double> sinks(threads);
+    std::vector<std::thread> pool;
+    auto start = std::chrono::high_resolution_clock::now();
+    for(int t = 0; t < threads; ++t)
+        pool.emplace_back(work, n, t, std::ref(sinks[t]));
+    for(std::thread & t : pool) t.join();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double sink = 0.0;
+    for(double s : sinks) sink += s;
+    std::cout << "ns per iteration : "
+              << std::chrono::duration<double, std::nano>(end - start).count() / n
+              << " (" << sink << ")" << std::endl;
+
+#ifdef TMP_PROFILE
+    std::cout << std::endl;
+    Profile::dump(std::cout);
+#endif
+    return 0;
+}
@@ -0,0 +1,363 @@
+#ifndef PROFILE_HPP
+#define PROFILE_HPP
+
+// Call profiling of the variants, opt-in at compile time with -DTMP_PROFILE.
+//
+// Without TMP_PROFILE the macros below expand to nothing (or to the plain
+// array pointer for the tables): the instrumented code is the same as the
+// uninstrumented one.
+//
+// With TMP_PROFILE, each thread counts the calls per entry point and order
+// in its own table (no atomic read-modify-write, no lock), and times one call
+// out of SAMPLE_PERIOD into a log2 histogram. Only the entry points are
+// instrumented: the recursion and the Pow and Factorial calls of Exp and Cos
+// go through the uninstrumented helpers (Pow_, Factorial_, ...).
+// The tables of the threads are merged by dump(), and at exit into the file
+// named by TMP_PROFILE_DUMP, if set.
+//
+//     TMP_PROFILE_SCOPE(name, order)  : statement, counts and samples the
+//                                       time until the end of the scope
+//     TMP_PROFILE_COUNT(name, order)  : void expression, counts only; for the
+//                                       constexpr functions, not counted when
+//                                       evaluated at compile time (and not at
+//                                       all without the compiler builtin that
+//                                       tells, see TMP_PROFILE_CONSTEXPR)
+//     TMP_PROFILE_TABLE(name, array)  : lookup table, counts operator[]
+
+#ifdef TMP_PROFILE
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Profile {
+
+    static std::size_t const SITES = 256;           // Per thread, power of 2
+    static std::uint64_t const SAMPLE_PERIOD = 256; // Power of 2
+    static int const BUCKETS = 32;                  // [2^i, 2^(i+1)) ns
+
+    struct Site
+    {
+        std::atomic<char const *> name; // nullptr: free slot, set after order
+        int order;
+
+        // Written by the owner thread only, read by dump()
+        std::atomic<std::uint64_t> calls;
+        std::atomic<std::uint64_t> histogram[BUCKETS];
+    };
+
+    struct Sites
+    {
+        Site sites[SITES];
+        std::atomic<std::uint64_t> dropped; // Calls to sites beyond SITES
+    };
+
+    // Single-writer increment: a plain load and store
+    inline void bump(std::atomic<std::uint64_t> & a, std::uint64_t n = 1)
+    {
+        a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    // Merged totals, keyed by name (the same literal can have several
+    // addresses) and order
+    struct Total
+    {
+        std::string name;
+        int order;
+        std::uint64_t calls;
+        std::uint64_t histogram[BUCKETS];
+    };
+
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<Sites *> live;
+        std::vector<Total> retired;
+        std::uint64_t dropped = 0;
+
+        static Registry & get();
+    };
+
+    inline void merge(Sites const & s, std::vector<Total> & totals, std::uint64_t & dropped)
+    {
+        dropped += s.dropped.load(std::memory_order_relaxed);
+        for(Site const & site : s.sites)
+        {
+            char const * name = site.name.load(std::memory_order_acquire);
+            if(!name) continue;
+            Total * t = nullptr;
+            for(Total & u : totals)
+                if(u.order == site.order && u.name == name) { t = &u; break; }
+            if(!t)
+            {
+                totals.push_back(Total());
+                t = &totals.back();
+                t->name = name;
+                t->order = site.order;
+                t->calls = 0;
+                std::memset(t->histogram, 0, sizeof t->histogram);
+            }
+            t->calls += site.calls.load(std::memory_order_relaxed);
+            for(int b = 0; b < BUCKETS; ++b)
+                t->histogram[b] += site.histogram[b].load(std::memory_order_relaxed);
+        }
+    }
+
+    // Registers the table of the thread, merges it into the retired totals at
+    // thread exit
+    struct Owner
+    {
+        Sites * sites;
+
+        Owner() : sites(new Sites())
+        {
+            Registry & r = Registry::get();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.live.push_back(sites);
+        }
+
+        ~Owner()
+        {
+            Registry & r = Registry::get();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            merge(*sites, r.retired, r.dropped);
+            for(std::size_t i = 0; i < r.live.size(); ++i)
+                if(r.live[i] == sites) { r.live.erase(r.live.begin() + i); break; }
+            delete sites;
+        }
+    };
+
+    // Trivial thread_locals (no initialization guard on the hot path), in
+    // inline functions so that all the translation units share them
+    inline Sites *& current()
+    {
+        static thread_local Sites * sites = nullptr;
+        return sites;
+    }
+
+    inline Sites & sites()
+    {
+        Sites *& s = current();
+        if(!s)
+        {
+            static thread_local Owner owner;
+            s = owner.sites;
+        }
+        return *s;
+    }
+
+    // nullptr if the table is full. Out of line: only the cache misses get
+    // here
+    __attribute__((noinline)) inline Site * site(char const * name, int order)
+    {
+        Sites & s = sites();
+        std::size_t h = (reinterpret_cast<std::uintptr_t>(name) >> 3) * 31u + static_cast<unsigned>(order);
+        for(std::size_t i = 0; i < SITES; ++i)
+        {
+            Site & site = s.sites[(h + i) & (SITES - 1)];
+            char const * n = site.name.load(std::memory_order_relaxed);
+            if(n == name && site.order == order) return &site;
+            if(!n)
+            {
+                site.order = order;
+                site.name.store(name, std::memory_order_release);
+                return &site;
+            }
+        }
+        bump(s.dropped);
+        return nullptr;
+    }
+
+    // Last site of a call site, per thread (trivial: no initialization guard)
+    struct Cache
+    {
+        Site * site;
+        char const * name;
+        int order;
+    };
+
+    // The site of (name, order), looked up only when it is not the cached one
+    inline Site * site(Cache & cache, char const * name, int order)
+    {
+        if(!cache.site || cache.name != name || cache.order != order)
+        {
+            cache.site = site(name, order);
+            cache.name = name;
+            cache.order = order;
+        }
+        return cache.site;
+    }
+
+    // One cache per line of the call sites (the lines of different files
+    // share one, the name tells them apart)
+    template <int LINE>
+    inline int count(char const * name, int order)
+    {
+        static thread_local Cache cache;
+        if(Site * s = site(cache, name, order)) bump(s->calls);
+        return 0;
+    }
+
+    // The calls that are not sampled only check the cache and count: the
+    // clock and the histogram are out of line
+    class Scope
+    {
+    public:
+        Scope(char const * name, int order, Cache & cache) : m_site(site(cache, name, order))
+        {
+            if(!m_site) return;
+            bump(m_site->calls);
+            if((m_site->calls.load(std::memory_order_relaxed) & (SAMPLE_PERIOD - 1)) == 0)
+                m_start = start();
+            else
+                m_site = nullptr;
+        }
+
+        ~Scope()
+        {
+            if(m_site) record(m_site, m_start);
+        }
+
+        Scope(Scope const &) = delete;
+        Scope & operator=(Scope const &) = delete;
+
+    private:
+        typedef std::chrono::steady_clock::time_point Time;
+
+        __attribute__((noinline)) static Time start()
+        {
+            return std::chrono::steady_clock::now();
+        }
+
+        __attribute__((noinline)) static void record(Site * site, Time start)
+        {
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            int b = 0;
+            while(b < BUCKETS - 1 && (std::int64_t(2) << b) <= ns) ++b;
+            bump(site->histogram[b]);
+        }
+
+        Site * m_site; // Sampled call only
+        Time m_start;
+    };
+
+    // Array pointer counting its lookups
+    class Table
+    {
+    public:
+        Table(char const * name, double const * array) : m_name(name), m_array(array) { }
+
+        template <typename I>
+        double operator[](I i) const
+        {
+            // Shared by the tables, a loop over one table always hits it
+            static thread_local Cache cache;
+            if(Site * s = site(cache, m_name, -1)) bump(s->calls);
+            return m_array[i];
+        }
+
+        operator double const *() const { return m_array; }
+
+    private:
+        char const * m_name;
+        double const * m_array;
+    };
+
+    // One line per entry point and order:
+    //     <name> <order> <calls> <sampled> <bucket>:<count>...
+    // order is -1 for the tables, bucket b holds the times in [2^b, 2^(b+1)) ns
+    inline void dump(std::ostream & os)
+    {
+        Registry & r = Registry::get();
+        std::vector<Total> totals;
+        std::uint64_t dropped;
+        {
+            std::lock_guard<std::mutex> lock(r.mutex);
+            totals = r.retired;
+            dropped = r.dropped;
+            for(Sites const * s : r.live) merge(*s, totals, dropped);
+        }
+
+        os << "# name order calls sampled bucket:count (bucket b = [2^b, 2^(b+1)) ns)" << std::endl;
+        for(Total const & t : totals)
+        {
+            std::uint64_t sampled = 0;
+            for(int b = 0; b < BUCKETS; ++b) sampled += t.histogram[b];
+            os << t.name << " " << t.order << " " << t.calls << " " << sampled;
+            for(int b = 0; b < BUCKETS; ++b)
+                if(t.histogram[b]) os << " " << b << ":" << t.histogram[b];
+            os << std::endl;
+        }
+        if(dropped) os << "# dropped " << dropped << std::endl;
+    }
+
+    // Dumps into TMP_PROFILE_DUMP at exit
+    struct AtExit
+    {
+        ~AtExit()
+        {
+            if(char const * path = std::getenv("TMP_PROFILE_DUMP"))
+            {
+                std::ofstream out(path);
+                dump(out);
+            }
+        }
+    };
+
+    inline Registry & Registry::get()
+    {
+        static Registry * registry = new Registry; // Outlives the threads
+        static AtExit at_exit;                     // Destroyed before it
+        return *registry;
+    }
+
+    // At startup, for the dump to be written even without any call
+    static bool const registered = (Registry::get(), true);
+
+}
+
+#define TMP_PROFILE_CAT_(a, b) a##b
+#define TMP_PROFILE_CAT(a, b) TMP_PROFILE_CAT_(a, b)
+
+#define TMP_PROFILE_SCOPE(name, order) \
+    static thread_local ::Profile::Cache TMP_PROFILE_CAT(tmp_profile_cache_, __LINE__); \
+    ::Profile::Scope TMP_PROFILE_CAT(tmp_profile_scope_, __LINE__)(name, order, \
+        TMP_PROFILE_CAT(tmp_profile_cache_, __LINE__))
+
+// The constexpr functions can only count if the compiler tells whether they
+// are evaluated at compile time (GCC >= 9 and Clang >= 9 in any standard
+// mode); without it, they are not counted
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define TMP_PROFILE_CONSTEXPR
+#endif
+#elif defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9
+#define TMP_PROFILE_CONSTEXPR
+#endif
+
+#ifdef TMP_PROFILE_CONSTEXPR
+#define TMP_PROFILE_COUNT(name, order) \
+    ((void)(__builtin_is_constant_evaluated() ? 0 : ::Profile::count<__LINE__>(name, order)))
+#else
+#define TMP_PROFILE_COUNT(name, order) ((void)0)
+#endif
+
+#define TMP_PROFILE_TABLE(name, array) ::Profile::Table(name, array)
+
+#else
+
+#define TMP_PROFILE_SCOPE(name, order)
+#define TMP_PROFILE_COUNT(name, order) ((void)0)
+#define TMP_PROFILE_TABLE(name, array) static_cast<double const *>(array)
+
+#endif
+
+#endif //PROFILE_HPP
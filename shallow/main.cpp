@@ -0,0 +1,73 @@
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+#include "../cos/cos.hpp"
+#include "../exp/exp.hpp"
+
+// Instantiates the struct variants and the factorial table at DEPTH, with the
+// linear chains (-DDEEP) or with the logarithmic-depth ones (default).
+// -DWITH_POW, -DWITH_FACTORIAL, -DWITH_EXP, -DWITH_COS or -DWITH_TABLE
+// restricts it to the given ones (all of them by default), -DWITH_NONE to
+// none of them (time of the headers alone).
+// Built by measure.sh to compare the compilation time and memory.
+
+#ifndef DEPTH
+#define DEPTH 500
+#endif
+
+#if !defined(WITH_POW) && !defined(WITH_FACTORIAL) && !defined(WITH_EXP) && \
+    !defined(WITH_COS) && !defined(WITH_TABLE) && !defined(WITH_NONE)
+#define WITH_POW
+#define WITH_FACTORIAL
+#define WITH_EXP
+#define WITH_COS
+#define WITH_TABLE
+#endif
+
+#ifdef DEEP
+namespace Struct = RecursiveTemplateStruct;
+namespace Array = CompileTimeArray;
+#else
+namespace Struct = ShallowTemplateStruct;
+namespace Array = ShallowCompileTimeArray;
+#endif
+
+#ifdef WITH_TABLE
+template struct Array::Table<DEPTH + 1>;
+#endif
+
+// Signed distance to the long double reference, in units of the last place
+// of the reference rounded to double
+static double ulps(double value, long double reference)
+{
+    double r = static_cast<double>(reference);
+    double ulp = std::nextafter(std::fabs(r), std::numeric_limits<double>::infinity()) - std::fabs(r);
+    return static_cast<double>((value - reference) / ulp);
+}
+
+int main()
+{
+    std::cout << std::setprecision(17);
+#ifdef WITH_FACTORIAL
+    std::cout << "Factorial<" << DEPTH << "> : " << Struct::Factorial<DEPTH>::Value << std::endl;
+#endif
+#ifdef WITH_POW
+    std::cout << "Pow<2, " << DEPTH << "> : " << Struct::Pow<2, DEPTH>::Value << std::endl;
+#endif
+#ifdef WITH_EXP
+    std::cout << "Exp<1, " << DEPTH << "> : " << Struct::Exp<1, DEPTH>::Value << " ("
+              << std::setprecision(3) << ulps(Struct::Exp<1, DEPTH>::Value, std::exp(1.0L))
+              << " ulp)" << std::setprecision(17) << std::endl;
+#endif
+#ifdef WITH_COS
+    std::cout << "Cos<45, " << DEPTH << "> : " << Struct::Cos<45, DEPTH>::Value << " ("
+              << std::setprecision(3) << ulps(Struct::Cos<45, DEPTH>::Value, std::cos(45.0L * M_PI / 180.0L))
+              << " ulp)" << std::setprecision(17) << std::endl;
+#endif
+#ifdef WITH_TABLE
+    std::cout << "Table<" << DEPTH + 1 << ">[20] : " << Array::Table<DEPTH + 1>::array[20] << std::endl;
+#endif
+    return 0;
+}
@@ -0,0 +1,50 @@
+#!/bin/sh
+# Compilation time and memory of the linear (deep) and logarithmic (shallow)
+# instantiation chains, as reported by g++ -ftime-report (wall time, GC memory),
+# for each construct alone.
+#
+#   ./measure.sh [N...]   (default: 500 5000 50000)
+#
+# Each compilation is limited to MEMORY_LIMIT KB of virtual memory (default
+# 4500000) and TIME_LIMIT seconds (default 600).
+
+[ $# -eq 0 ] && set -- 500 5000 50000
+MEMORY_LIMIT=${MEMORY_LIMIT:-4500000}
+TIME_LIMIT=${TIME_LIMIT:-600}
+
+printf "%-8s %-10s %-8s %10s %10s  %s\n" "N" "construct" "variant" "time (s)" "memory" "status"
+
+# The headers alone, to subtract from the times below
+report=$(g++ -std=c++11 -c main.cpp -o /dev/null -DWITH_NONE -ftime-report 2>&1)
+total=$(echo "$report" | grep "^ TOTAL")
+printf "%-8s %-10s %-8s %10s %10s  %s\n" - NONE - \
+    "$(echo "$total" | awk -F: '{ split($2, a, " "); print a[3] }')" "$(echo "$total" | awk '{ print $NF }')" ok
+
+for n in "$@"; do
+    for construct in POW FACTORIAL EXP COS TABLE; do
+        for variant in deep shallow; do
+            flags="-DDEPTH=$n -DWITH_$construct"
+            # Cos<X, N> needs Factorial<2N>, never below the default of 900
+            depth=$((2 * n + 100))
+            [ $depth -lt 900 ] && depth=900
+            [ $variant = deep ] && flags="$flags -DDEEP -ftemplate-depth=$depth"
+
+            report=$( (ulimit -v $MEMORY_LIMIT; timeout $TIME_LIMIT \
+                       g++ -std=c++11 -c main.cpp -o /dev/null $flags -ftime-report) 2>&1)
+            status=$?
+            total=$(echo "$report" | grep "^ TOTAL")
+            time=$(echo "$total" | awk -F: '{ split($2, a, " "); print a[3] }')
+            memory=$(echo "$total" | awk '{ print $NF }')
+            if [ $status -eq 0 ]; then
+                status=ok
+            elif [ $status -eq 124 ]; then
+                status="failed: over ${TIME_LIMIT}s"
+            elif echo "$report" | grep -q -E "out of memory|virtual memory exhausted|Cannot allocate"; then
+                status="failed: out of memory"
+            else
+                status="failed: $(echo "$report" | grep -m1 -E "error|internal" | cut -c1-60)"
+            fi
+            printf "%-8s %-10s %-8s %10s %10s  %s\n" $n $construct $variant "$time" "$memory" "$status"
+        done
+    done
+done
@@ -0,0 +1,85 @@
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+#include "stream.hpp"
+
+static void usage()
+{
+    std::cerr << "./stream <pow|factorial|exp|cos> <order> [-f] [-t <threads>] "
+                 "[-b <batch_bytes>] [file] < in > out" << std::endl;
+}
+
+// strtol of the whole of s into [lo, hi]
+static bool parse(char const * s, long lo, long hi, long & value)
+{
+    char * end;
+    errno = 0;
+    value = std::strtol(s, &end, 10);
+    return end != s && !*end && errno == 0 && value >= lo && value <= hi;
+}
+
+int main(int argc, char ** argv)
+{
+    if(argc < 3)
+    {
+        usage();
+        return 1;
+    }
+
+    Stream::Config cfg;
+
+    if(!strcmp(argv[1], "pow"))            cfg.function = Stream::Function::Pow;
+    else if(!strcmp(argv[1], "factorial")) cfg.function = Stream::Function::Factorial;
+    else if(!strcmp(argv[1], "exp"))       cfg.function = Stream::Function::Exp;
+    else if(!strcmp(argv[1], "cos"))       cfg.function = Stream::Function::Cos;
+    else
+    {
+        usage();
+        return 1;
+    }
+
+    long value;
+    if(!parse(argv[2], 0, Stream::MAX_ORDER, value))
+    {
+        std::cerr << "<order> must be in [0, " << Stream::MAX_ORDER << "]" << std::endl;
+        usage();
+        return 1;
+    }
+    cfg.order = static_cast<int>(value);
+
+    for(int i = 3; i < argc; ++i)
+    {
+        if(!strcmp(argv[i], "-f"))
+        {
+            cfg.single = true;
+        }
+        else if(!strcmp(argv[i], "-t") && i + 1 < argc &&
+                parse(argv[i + 1], 1, Stream::MAX_THREADS, value))
+        {
+            cfg.threads = static_cast<unsigned>(value);
+            ++i;
+        }
+        else if(!strcmp(argv[i], "-b") && i + 1 < argc &&
+                parse(argv[i + 1], 1, std::numeric_limits<long>::max(), value))
+        {
+            cfg.batch = static_cast<std::size_t>(value);
+            ++i;
+        }
+        else if(argv[i][0] != '-')
+        {
+            cfg.path = argv[i];
+        }
+        else
+        {
+            std::cerr << "Bad option " << argv[i] << " (<threads> in [1, "
+                      << Stream::MAX_THREADS << "], <batch_bytes> positive)" << std::endl;
+            usage();
+            return 1;
+        }
+    }
+
+    return Stream::stream(cfg);
+}
@@ -0,0 +1,240 @@
+#ifndef STREAM_HPP
+#define STREAM_HPP
+
+#include "../cos/cos.hpp"
+#include "../exp/exp.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Raw streams of doubles (or floats) are read from stdin or from a
+// memory-mapped file, evaluated batch by batch with the Inline variants and
+// written back as raw values of the same type on stdout.
+
+namespace Stream {
+
+    enum class Function { Pow, Factorial, Exp, Cos };
+
+    // The Inline variants recurse once per term (twice as deep for Cos)
+    int const MAX_ORDER = 10000;
+    unsigned const MAX_THREADS = 256;
+
+    struct Config
+    {
+        Function function = Function::Cos;
+        int order = 10;             // Exponent for Pow, order for Exp and Cos, in [0, MAX_ORDER]
+        bool single = false;        // float instead of double
+        unsigned threads = 1;       // In [1, MAX_THREADS]
+        std::size_t batch = 16384;  // Bytes of input per batch (in + out in L1)
+        char const * path = nullptr; // nullptr => stdin
+    };
+
+//==============================================================================
+// Kernels
+//==============================================================================
+
+    inline double Factorial(double x)
+    {
+        // Keep the recursion of Inline::Factorial bounded
+        return x < 0.0 || x != x ? std::numeric_limits<double>::quiet_NaN() :
+               x > 170.0 ? std::numeric_limits<double>::infinity() :
+               Inline::Factorial(static_cast<int>(x));
+    }
+
+    // The switch is hoisted out of the element loop
+    template <typename T>
+    void evaluate(Function f, int order, T const * in, T * out, std::size_t count)
+    {
+        switch(f)
+        {
+            case Function::Pow:
+                for(std::size_t i = 0; i < count; ++i)
+                    out[i] = static_cast<T>(Inline::Pow(in[i], order));
+                break;
+            case Function::Factorial:
+                for(std::size_t i = 0; i < count; ++i)
+                    out[i] = static_cast<T>(Factorial(in[i]));
+                break;
+            case Function::Exp:
+                for(std::size_t i = 0; i < count; ++i)
+                    out[i] = static_cast<T>(Inline::Exp(in[i], order));
+                break;
+            case Function::Cos:
+                for(std::size_t i = 0; i < count; ++i)
+                    out[i] = static_cast<T>(Inline::Cos(in[i], order));
+                break;
+        }
+    }
+
+    // Evaluates [in, in + count) in batches of `batch` elements
+    template <typename T>
+    void evaluate_batched(Config const & cfg, std::size_t batch,
+                          T const * in, T * out, std::size_t count)
+    {
+        for(std::size_t i = 0; i < count; i += batch)
+        {
+            evaluate(cfg.function, cfg.order, in + i, out + i,
+                     std::min(batch, count - i));
+        }
+    }
+
+    // Splits a window of elements between the threads, the calling thread
+    // taking the first slice
+    template <typename T>
+    void evaluate_window(Config const & cfg, std::size_t batch,
+                         T const * in, T * out, std::size_t count)
+    {
+        if(cfg.threads <= 1 || count <= batch)
+        {
+            evaluate_batched(cfg, batch, in, out, count);
+            return;
+        }
+
+        std::size_t batches = (count + batch - 1) / batch;
+        std::size_t per_thread = (batches + cfg.threads - 1) / cfg.threads * batch;
+
+        std::vector<std::thread> workers;
+        for(std::size_t begin = per_thread; begin < count; begin += per_thread)
+        {
+            std::size_t size = std::min(per_thread, count - begin);
+            workers.emplace_back(evaluate_batched<T>, std::cref(cfg), batch,
+                                 in + begin, out + begin, size);
+        }
+        evaluate_batched(cfg, batch, in, out, std::min(per_thread, count));
+
+        for(auto & w : workers) w.join();
+    }
+
+//==============================================================================
+// I/O
+//==============================================================================
+
+    // Returns the number of bytes read (< size only at end of stream)
+    inline std::size_t read_full(int fd, char * buffer, std::size_t size)
+    {
+        std::size_t done = 0;
+        while(done < size)
+        {
+            ssize_t r = ::read(fd, buffer + done, size - done);
+            if(r == 0) break;
+            if(r < 0) { if(errno == EINTR) continue; return done; }
+            done += static_cast<std::size_t>(r);
+        }
+        return done;
+    }
+
+    inline bool write_full(int fd, char const * buffer, std::size_t size)
+    {
+        while(size > 0)
+        {
+            ssize_t w = ::write(fd, buffer, size);
+            if(w < 0) { if(errno == EINTR) continue; return false; }
+            buffer += w;
+            size -= static_cast<std::size_t>(w);
+        }
+        return true;
+    }
+
+//==============================================================================
+// Streaming evaluation
+//==============================================================================
+
+    // Returns the number of input bytes processed, or -1 on I/O error
+    template <typename T>
+    long long run(Config const & cfg)
+    {
+        std::size_t batch = std::max<std::size_t>(1, cfg.batch / sizeof(T));
+        // Each thread gets several batches per window to amortize its start
+        std::size_t window = batch * 64 * std::max(1u, cfg.threads);
+
+        std::vector<T> out(window);
+        long long total = 0;
+
+        if(cfg.path)
+        {
+            int fd = ::open(cfg.path, O_RDONLY);
+            if(fd < 0) { std::perror(cfg.path); return -1; }
+
+            struct stat st;
+            if(::fstat(fd, &st) < 0) { std::perror(cfg.path); ::close(fd); return -1; }
+
+            std::size_t count = static_cast<std::size_t>(st.st_size) / sizeof(T);
+            if(count == 0) { ::close(fd); return 0; }
+
+            void * map = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if(map == MAP_FAILED) { std::perror("mmap"); return -1; }
+            ::madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+            // The input is evaluated in place, straight from the mapping
+            T const * in = static_cast<T const *>(map);
+            for(std::size_t i = 0; i < count; i += window)
+            {
+                std::size_t size = std::min(window, count - i);
+                evaluate_window(cfg, batch, in + i, out.data(), size);
+                if(!write_full(STDOUT_FILENO, reinterpret_cast<char const *>(out.data()),
+                               size * sizeof(T)))
+                {
+                    ::munmap(map, st.st_size);
+                    return -1;
+                }
+            }
+            total = static_cast<long long>(count * sizeof(T));
+
+            ::munmap(map, st.st_size);
+        }
+        else
+        {
+            std::vector<T> in(window);
+            for(;;)
+            {
+                std::size_t bytes = read_full(STDIN_FILENO,
+                    reinterpret_cast<char *>(in.data()), window * sizeof(T));
+                std::size_t size = bytes / sizeof(T);
+                if(size == 0) break;
+
+                evaluate_window(cfg, batch, in.data(), out.data(), size);
+                if(!write_full(STDOUT_FILENO, reinterpret_cast<char const *>(out.data()),
+                               size * sizeof(T)))
+                    return -1;
+
+                total += static_cast<long long>(size * sizeof(T));
+                if(bytes < window * sizeof(T)) break;
+            }
+        }
+
+        return total;
+    }
+
+    // Streams stdin/file to stdout and reports the throughput on stderr
+    inline int stream(Config const & cfg)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        long long bytes = cfg.single ? run<float>(cfg) : run<double>(cfg);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        if(bytes < 0) return 1;
+
+        double s = std::chrono::duration<double>(end - start).count();
+        std::size_t size = cfg.single ? sizeof(float) : sizeof(double);
+        std::cerr << bytes / size << " elements (" << bytes << " bytes) in "
+                  << s * 1e3 << "ms : " << (s > 0 ? bytes / s * 1e-9 : 0.0)
+                  << " GB/s" << std::endl;
+        return 0;
+    }
+
+}
+
+#endif //STREAM_HPP
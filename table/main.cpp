@@ -0,0 +1,17 @@
+#include <iostream>
+
+#include "table.hpp"
+
+int main(int argc, char ** argv)
+{
+    if(argc > 1)
+    {
+        std::cout << "Computing " << atoi(argv[1]) << " random lookups per table : \n" << std::endl;
+        CompactTable::benchmark(atoi(argv[1]));
+    }
+    else
+    {
+        std::cout << "./table <loop_count>" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,420 @@
+#ifndef TABLE_HPP
+#define TABLE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <unistd.h>
+
+// Compact lookup tables for hot loops.
+//
+// The compile-time arrays store one double per integer step, in as many
+// static arrays as there are functions. These tables trade precision for
+// footprint (double, float or half storage, widened to double on load) and
+// keep together what is read together (value and slope, cos and sin), so
+// that a lookup touches a single cache line.
+//
+// The size of the tables is a runtime parameter (to sweep it in the
+// benchmark), hence they are filled at construction.
+
+namespace CompactTable {
+
+//==============================================================================
+// Half precision storage
+//==============================================================================
+
+    // IEEE 754 binary16, converted in software (no F16C assumed)
+    struct Half
+    {
+        std::uint16_t bits;
+
+        Half() = default;
+
+        explicit Half(double d) : bits(from_float(static_cast<float>(d))) { }
+
+        operator double() const { return to_float(bits); }
+
+        static float to_float(std::uint16_t h)
+        {
+            // Exponent/mantissa moved to the float position then rebiased by
+            // a multiplication, which also handles the subnormals
+            std::uint32_t em = static_cast<std::uint32_t>(h & 0x7fff) << 13;
+            std::uint32_t sign = static_cast<std::uint32_t>(h & 0x8000) << 16;
+            float f;
+            std::memcpy(&f, &em, sizeof f);
+            f *= 5.192296858534828e+33f; // 2^112
+            std::uint32_t u;
+            std::memcpy(&u, &f, sizeof u);
+            if(em >= 0x0f800000u) u = 0x7f800000u | em; // Inf/NaN
+            u |= sign;
+            std::memcpy(&f, &u, sizeof f);
+            return f;
+        }
+
+        static std::uint16_t from_float(float f)
+        {
+            std::uint32_t u;
+            std::memcpy(&u, &f, sizeof u);
+            std::uint16_t sign = static_cast<std::uint16_t>((u >> 16) & 0x8000);
+            u &= 0x7fffffffu;
+
+            if(u >= 0x7f800000u) // Inf/NaN
+                return sign | 0x7c00 | (u > 0x7f800000u ? 0x200 : 0);
+            if(u >= 0x477ff000u) // Overflow after rounding
+                return sign | 0x7c00;
+            if(u < 0x38800000u) // Subnormal or zero: let the FPU round
+            {
+                float a;
+                std::memcpy(&a, &u, sizeof a);
+                return sign | static_cast<std::uint16_t>(std::nearbyint(a * 16777216.0f)); // 2^24
+            }
+
+            // Normal: rebias and round to nearest even on the 13 dropped bits
+            std::uint32_t r = u - 0x38000000u;
+            r += 0x0fffu + ((r >> 13) & 1u);
+            return sign | static_cast<std::uint16_t>(r >> 13);
+        }
+    };
+
+    // u truncated into [0, last], 0 for NaN: converting a negative, too
+    // large or NaN double to an integer is undefined
+    inline std::size_t Index(double u, std::size_t last)
+    {
+        return u >= 0.0 ? (u < static_cast<double>(last) ? static_cast<std::size_t>(u) : last) : 0;
+    }
+
+//==============================================================================
+// Plain table: f(lo + i * step), nearest lookup
+//==============================================================================
+    template <typename T>
+    class ValueTable
+    {
+    public:
+        template <typename F>
+        ValueTable(F f, double lo, double hi, std::size_t size)
+            : m_lo(lo), m_inv_step((size - 1) / (hi - lo)), m_values(size)
+        {
+            double step = (hi - lo) / (size - 1);
+            for(std::size_t i = 0; i < size; ++i)
+                m_values[i] = T(f(lo + i * step));
+        }
+
+        // Clamped to f(lo) below lo and to f(hi) above hi
+        double operator()(double x) const
+        {
+            return static_cast<double>(m_values[Index((x - m_lo) * m_inv_step + 0.5, m_values.size() - 1)]);
+        }
+
+        std::size_t bytes() const { return m_values.size() * sizeof(T); }
+
+    private:
+        double m_lo;
+        double m_inv_step;
+        std::vector<T> m_values;
+    };
+
+//==============================================================================
+// Interpolation table: interleaved (value, derivative) pairs
+//==============================================================================
+    template <typename T>
+    class LerpTable
+    {
+    public:
+        struct Entry
+        {
+            T value;
+            T slope; // (f(x[i + 1]) - f(x[i])) / step, of the order of f'
+                     // so that it does not fall in the half subnormals
+        };
+
+        template <typename F>
+        LerpTable(F f, double lo, double hi, std::size_t size)
+            : m_lo(lo), m_step((hi - lo) / (size - 1)), m_inv_step((size - 1) / (hi - lo)),
+              m_entries(size)
+        {
+            for(std::size_t i = 0; i < size; ++i)
+            {
+                double v = f(lo + i * m_step);
+                m_entries[i].value = T(v);
+                m_entries[i].slope = T((f(lo + (i + 1) * m_step) - v) * m_inv_step);
+            }
+        }
+
+        // Extrapolated from the first entry below lo, from the last one above hi
+        double operator()(double x) const
+        {
+            double u = (x - m_lo) * m_inv_step;
+            std::size_t i = Index(u, m_entries.size() - 1);
+            Entry const & e = m_entries[i];
+            return static_cast<double>(e.value) + (u - i) * m_step * static_cast<double>(e.slope);
+        }
+
+        std::size_t bytes() const { return m_entries.size() * sizeof(Entry); }
+
+    private:
+        double m_lo;
+        double m_step;
+        double m_inv_step;
+        std::vector<Entry> m_entries;
+    };
+
+    // Same with the values and slopes in two separate arrays
+    template <typename T>
+    class SplitLerpTable
+    {
+    public:
+        template <typename F>
+        SplitLerpTable(F f, double lo, double hi, std::size_t size)
+            : m_lo(lo), m_step((hi - lo) / (size - 1)), m_inv_step((size - 1) / (hi - lo)),
+              m_values(size), m_slopes(size)
+        {
+            for(std::size_t i = 0; i < size; ++i)
+            {
+                double v = f(lo + i * m_step);
+                m_values[i] = T(v);
+                m_slopes[i] = T((f(lo + (i + 1) * m_step) - v) * m_inv_step);
+            }
+        }
+
+        double operator()(double x) const
+        {
+            double u = (x - m_lo) * m_inv_step;
+            std::size_t i = Index(u, m_values.size() - 1);
+            return static_cast<double>(m_values[i]) + (u - i) * m_step * static_cast<double>(m_slopes[i]);
+        }
+
+        std::size_t bytes() const { return m_values.size() * 2 * sizeof(T); }
+
+    private:
+        double m_lo;
+        double m_step;
+        double m_inv_step;
+        std::vector<T> m_values;
+        std::vector<T> m_slopes;
+    };
+
+//==============================================================================
+// Sin/cos table: interleaved (cos, sin) pairs over [0, 2pi)
+//==============================================================================
+    template <typename T>
+    class SinCosTable
+    {
+    public:
+        struct Entry
+        {
+            T cos;
+            T sin;
+        };
+
+        explicit SinCosTable(std::size_t size)
+            : m_step(2.0 * M_PI / size), m_inv_step(size / (2.0 * M_PI)), m_entries(size)
+        {
+            for(std::size_t i = 0; i < size; ++i)
+            {
+                m_entries[i].cos = T(std::cos(i * m_step));
+                m_entries[i].sin = T(std::sin(i * m_step));
+            }
+        }
+
+        // x in [0, 2pi). The pair at the nearest point is rotated by the
+        // remainder d: cos(a + d) = cos a cos d - sin a sin d, where d is
+        // small enough for the low-order Taylor terms. Outside of [0, 2pi)
+        // d is not small anymore and the result is wrong (but defined).
+        void operator()(double x, double & s, double & c) const
+        {
+            std::size_t i = Index(x * m_inv_step + 0.5, m_entries.size());
+            double d = x - i * m_step;
+            Entry const & e = m_entries[i < m_entries.size() ? i : 0];
+            double d2 = d * d;
+            double cd = 1.0 - d2 * 0.5;
+            double sd = d - d * d2 * (1.0 / 6.0);
+            double ca = static_cast<double>(e.cos);
+            double sa = static_cast<double>(e.sin);
+            c = ca * cd - sa * sd;
+            s = sa * cd + ca * sd;
+        }
+
+        std::size_t bytes() const { return m_entries.size() * sizeof(Entry); }
+
+    private:
+        double m_step;
+        double m_inv_step;
+        std::vector<Entry> m_entries;
+    };
+
+    // Same with the cosinus and sinus in two separate arrays
+    template <typename T>
+    class SplitSinCosTable
+    {
+    public:
+        explicit SplitSinCosTable(std::size_t size)
+            : m_step(2.0 * M_PI / size), m_inv_step(size / (2.0 * M_PI)),
+              m_cos(size), m_sin(size)
+        {
+            for(std::size_t i = 0; i < size; ++i)
+            {
+                m_cos[i] = T(std::cos(i * m_step));
+                m_sin[i] = T(std::sin(i * m_step));
+            }
+        }
+
+        void operator()(double x, double & s, double & c) const
+        {
+            std::size_t i = Index(x * m_inv_step + 0.5, m_cos.size());
+            double d = x - i * m_step;
+            if(i >= m_cos.size()) i = 0;
+            double d2 = d * d;
+            double cd = 1.0 - d2 * 0.5;
+            double sd = d - d * d2 * (1.0 / 6.0);
+            double ca = static_cast<double>(m_cos[i]);
+            double sa = static_cast<double>(m_sin[i]);
+            c = ca * cd - sa * sd;
+            s = sa * cd + ca * sd;
+        }
+
+        std::size_t bytes() const { return m_cos.size() * 2 * sizeof(T); }
+
+    private:
+        double m_step;
+        double m_inv_step;
+        std::vector<T> m_cos;
+        std::vector<T> m_sin;
+    };
+
+//==============================================================================
+// Benchmark: throughput as the tables grow out of the caches
+//==============================================================================
+
+    // Uniform random doubles in [0, 1), cheap enough not to hide the lookups
+    struct Random
+    {
+        std::uint64_t state = 0x9e3779b97f4a7c15ull;
+
+        double operator()()
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return (state >> 11) * (1.0 / 9007199254740992.0);
+        }
+    };
+
+    // ns per lookup of n random lookups in [0, 2pi)
+    template <typename Table>
+    double time_lookup(Table const & table, int n, double & sink)
+    {
+        Random r;
+        double sum = 0.0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for(int i = 0; i < n; ++i)
+        {
+            sum += table(r() * (2.0 * M_PI));
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        sink += sum;
+        return std::chrono::duration<double, std::nano>(end - start).count() / n;
+    }
+
+    template <typename Table>
+    double time_sincos(Table const & table, int n, double & sink)
+    {
+        Random r;
+        double sum = 0.0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for(int i = 0; i < n; ++i)
+        {
+            double s, c;
+            table(r() * (2.0 * M_PI), s, c);
+            sum += s + c;
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        sink += sum;
+        return std::chrono::duration<double, std::nano>(end - start).count() / n;
+    }
+
+    // Max error of the interpolated cosinus and of the sin/cos pair
+    template <typename T>
+    void print_errors(std::size_t size)
+    {
+        auto cos_func = [](double x) { return std::cos(x); };
+        LerpTable<T> lerp(cos_func, 0.0, 2.0 * M_PI, size);
+        SinCosTable<T> sincos(size);
+
+        double lerp_err = 0.0, sincos_err = 0.0;
+        Random r;
+        for(int i = 0; i < 100000; ++i)
+        {
+            double x = r() * (2.0 * M_PI);
+            double s, c;
+            sincos(x, s, c);
+            lerp_err = std::max(lerp_err, std::abs(lerp(x) - std::cos(x)));
+            sincos_err = std::max(sincos_err, std::max(std::abs(c - std::cos(x)),
+                                                       std::abs(s - std::sin(x))));
+        }
+        std::cout << "    lerp " << lerp_err << ", sincos " << sincos_err << std::endl;
+    }
+
+    template <typename T>
+    void print_row(char const * type, std::size_t size, int n, double & sink)
+    {
+        auto cos_func = [](double x) { return std::cos(x); };
+
+        ValueTable<T> value(cos_func, 0.0, 2.0 * M_PI, size);
+        LerpTable<T> lerp(cos_func, 0.0, 2.0 * M_PI, size);
+        SplitLerpTable<T> split_lerp(cos_func, 0.0, 2.0 * M_PI, size);
+        SinCosTable<T> sincos(size);
+        SplitSinCosTable<T> split_sincos(size);
+
+        std::cout << std::setw(9) << size << std::setw(8) << type
+                  << std::setw(12) << lerp.bytes() / 1024.0
+                  << std::setw(10) << time_lookup(value, n, sink)
+                  << std::setw(10) << time_lookup(lerp, n, sink)
+                  << std::setw(10) << time_lookup(split_lerp, n, sink)
+                  << std::setw(10) << time_sincos(sincos, n, sink)
+                  << std::setw(10) << time_sincos(split_sincos, n, sink)
+                  << std::endl;
+    }
+
+    void benchmark(int n)
+    {
+        std::cout << "L1d: " << sysconf(_SC_LEVEL1_DCACHE_SIZE) / 1024 << "KB, "
+                  << "L2: " << sysconf(_SC_LEVEL2_CACHE_SIZE) / 1024 << "KB, "
+                  << "L3: " << sysconf(_SC_LEVEL3_CACHE_SIZE) / 1024 << "KB"
+                  << std::endl << std::endl;
+
+        std::cout << "Max error with 1024 entries:" << std::endl;
+        print_errors<double>(1024);
+        print_errors<float>(1024);
+        print_errors<Half>(1024);
+        std::cout << std::endl;
+
+        std::cout << "ns per lookup (KB = footprint of the interleaved tables)"
+                  << std::endl << std::endl;
+        std::cout << std::setw(9) << "entries" << std::setw(8) << "type"
+                  << std::setw(12) << "KB"
+                  << std::setw(10) << "value"
+                  << std::setw(10) << "lerp"
+                  << std::setw(10) << "lerp/2"
+                  << std::setw(10) << "sincos"
+                  << std::setw(10) << "sincos/2" << std::endl;
+
+        double sink = 0.0;
+        std::cout << std::fixed << std::setprecision(2);
+        for(std::size_t size = 1u << 8; size <= 1u << 22; size <<= 2)
+        {
+            print_row<double>("double", size, n, sink);
+            print_row<float>("float", size, n, sink);
+            print_row<Half>("half", size, n, sink);
+        }
+        std::cout << std::endl << "(" << sink << ")" << std::endl;
+    }
+
+}
+
+#endif //TABLE_HPP